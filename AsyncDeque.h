@@ -0,0 +1,247 @@
+// ---------------------------
+// projects/deque/AsyncDeque.h
+// Copyright (C) 2012
+// Glenn P. Downing
+// ---------------------------
+
+#ifndef AsyncDeque_h
+#define AsyncDeque_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <memory> // allocator
+
+#include "Deque.h"
+#include "Executor.h"
+
+// ----------
+// AsyncDeque
+// ----------
+
+/**
+ * A bounded FIFO between pipeline stages that never blocks a thread. A
+ * stage is a Task; push_back and pop_front take the Task to resume once
+ * the operation completes. If it cannot complete yet (the deque is full,
+ * or empty) the Task is parked in the deque, not on a thread, and is
+ * posted to the Executor by the pop_front or push_back that completes it.
+ * A full deque so holds producers back until consumers catch up.
+ * Safe to use from the threads of a ThreadPoolExecutor.
+ */
+template < typename T, typename A = std::allocator<T> >
+class AsyncDeque {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef MyDeque<T, A> container_type;
+
+        typedef typename container_type::allocator_type allocator_type;
+        typedef typename container_type::value_type value_type;
+        typedef typename container_type::size_type size_type;
+        typedef typename container_type::const_reference const_reference;
+
+    private:
+        // a producer waiting for room
+        struct Pusher {
+            value_type v;
+            Task* t;};
+
+        // a consumer waiting for a value
+        struct Popper {
+            value_type* v;
+            Task* t;};
+
+        typedef MyDeque<Pusher, typename A::template rebind<Pusher>::other> pushers_type;
+        typedef MyDeque<Popper, typename A::template rebind<Popper>::other> poppers_type;
+
+        // Tasks to post once the lock is released
+        struct Ready {
+            Task* t[2];
+            int n;
+
+            Ready () : n(0) {}
+
+            void add (Task* p) {
+                assert(n != 2);
+                t[n++] = p;}};
+
+    private:
+        // ----
+        // data
+        // ----
+
+        Executor& _x;
+        size_type _capacity;
+
+        mutable Mutex _m;
+
+        container_type _items;
+        pushers_type _pushers;
+        poppers_type _poppers;
+
+    private:
+        // -----
+        // valid
+        // -----
+
+        bool valid () const {
+            return (_items.size() <= _capacity) &&
+                   (_pushers.empty() || (_items.size() == _capacity)) &&
+                   (_poppers.empty() || _items.empty());}
+
+        void post (const Ready& r) {
+            for (int i = 0; i != r.n; ++i)
+                _x.post(r.t[i]);}
+
+        /**
+	 * moves a value into the deque, or straight to a waiting consumer
+	 * @return false if the deque is full
+	 */
+        bool put (const_reference v, Ready& r) {
+            if (!_poppers.empty()) {
+                const Popper p = _poppers.front();
+                _poppers.pop_front();
+                *p.v = v;
+                r.add(p.t);}
+            else if (_items.size() < _capacity)
+                _items.push_back(v);
+            else
+                return false;
+            return true;}
+
+        /**
+	 * moves a value out of the deque, or straight from a waiting producer,
+	 * and lets the first waiting producer into the space that frees
+	 * @return false if there is no value
+	 */
+        bool take (value_type& v, Ready& r) {
+            if (!_items.empty()) {
+                v = _items.front();
+                _items.pop_front();
+                if (!_pushers.empty()) {
+                    const Pusher& p = _pushers.front();
+                    _items.push_back(p.v);
+                    r.add(p.t);
+                    _pushers.pop_front();}}
+            else if (!_pushers.empty()) {
+                const Pusher& p = _pushers.front();
+                v = p.v;
+                r.add(p.t);
+                _pushers.pop_front();}
+            else
+                return false;
+            return true;}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+	 * @param x the Executor that parked Tasks are posted to
+	 * @param capacity the most values the deque holds; with 0 every push_back waits for a pop_front
+	 * @param a the allocator to use
+	 */
+        AsyncDeque (Executor& x, size_type capacity, const allocator_type& a = allocator_type()) :
+                _x(x), _capacity(capacity), _items(a), _pushers(a), _poppers(a) {
+            assert(valid());}
+
+        // -----------
+        // empty, size
+        // -----------
+
+        bool empty () const {
+            Lock l(_m);
+            return _items.empty();}
+
+        /**
+	 * @return the number of values in the deque, not counting those of parked producers
+	 */
+        size_type size () const {
+            Lock l(_m);
+            return _items.size();}
+
+        size_type capacity () const {
+            return _capacity;}
+
+        // ---------
+        // pop_front
+        // ---------
+
+        /**
+	 * moves the front value into v, then posts t; if there is none, t is
+	 * parked and v is filled in, and t posted, by a later push_back
+	 * @param v where the value goes; must stay valid until t runs
+	 * @param t the Task to resume
+	 */
+        void pop_front (value_type& v, Task* t) {
+            assert(t);
+            Ready r;
+            {
+            Lock l(_m);
+            if (take(v, r))
+                r.add(t);
+            else {
+                const Popper p = {&v, t};
+                _poppers.push_back(p);}
+            assert(valid());
+            }
+            post(r);}
+
+        /**
+	 * @return false, leaving v alone, if there is no value to pop without waiting
+	 */
+        bool try_pop_front (value_type& v) {
+            Ready r;
+            bool b;
+            {
+            Lock l(_m);
+            b = take(v, r);
+            assert(valid());
+            }
+            post(r);
+            return b;}
+
+        // ---------
+        // push_back
+        // ---------
+
+        /**
+	 * appends v, then posts t; if the deque is full, t is parked with a
+	 * copy of v until a later pop_front makes room
+	 * @param v the value to append
+	 * @param t the Task to resume
+	 */
+        void push_back (const_reference v, Task* t) {
+            assert(t);
+            Ready r;
+            {
+            Lock l(_m);
+            if (put(v, r))
+                r.add(t);
+            else {
+                const Pusher p = {v, t};
+                _pushers.push_back(p);}
+            assert(valid());
+            }
+            post(r);}
+
+        /**
+	 * @return false, leaving the deque alone, if v cannot be appended without waiting
+	 */
+        bool try_push_back (const_reference v) {
+            Ready r;
+            bool b;
+            {
+            Lock l(_m);
+            b = put(v, r);
+            assert(valid());
+            }
+            post(r);
+            return b;}};
+
+#endif // AsyncDeque_h
@@ -0,0 +1,525 @@
+// -----------------------------
+// projects/deque/BenchDeque.c++
+// Copyright (C) 2012
+// Glenn P. Downing
+// -----------------------------
+
+/*
+To run the benchmarks:
+% g++ -ansi -pedantic -Wall -O2 -DNDEBUG BenchDeque.c++ -o BenchDeque.c++.app -lpthread
+% BenchDeque.c++.app
+Build again with -DDEQUE_NO_PREFETCH to time the scans without row prefetching.
+*/
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // copy, count, equal, find
+#include <cstdio> // printf
+#include <deque> // deque
+#include <memory> // allocator
+#include <numeric> // accumulate
+#include <sys/time.h> // gettimeofday
+#include <vector> // vector
+
+#include "AsyncDeque.h"
+#include "BlockAllocator.h"
+#include "ColumnarDeque.h"
+#include "Deque.h"
+#include "Executor.h"
+#include "PersistentDeque.h"
+#include "SlidingWindow.h"
+
+// -------
+// seconds
+// -------
+
+double seconds () {
+    timeval t;
+    gettimeofday(&t, 0);
+    return t.tv_sec + t.tv_usec / 1e6;}
+
+// ----
+// sink
+// ----
+
+// keeps the optimizer from discarding the work being timed
+volatile long sink;
+
+// --------
+// versions
+// --------
+
+/**
+ * Keeps every version of a deque of n elements alive while appending one
+ * element per version: copying a MyDeque per version vs sharing structure.
+ */
+void bench_versions (int n, int versions) {
+    double t = seconds();
+    {
+    std::vector< MyDeque<int>* > v;
+    v.push_back(new MyDeque<int>(n, 0));
+    for (int i = 0; i != versions; ++i) {
+        v.push_back(new MyDeque<int>(*v.back()));
+        v.back()->push_back(i);}
+    sink = v.back()->back();
+    for (int i = 0; i != int(v.size()); ++i)
+        delete v[i];
+    }
+    const double copying = seconds() - t;
+
+    t = seconds();
+    {
+    PersistentDeque<int> p;
+    for (int i = 0; i != n; ++i)
+        p = p.push_back(0);
+    std::vector< PersistentDeque<int> > v(1, p);
+    for (int i = 0; i != versions; ++i)
+        v.push_back(v.back().push_back(i));
+    sink = v.back().back();
+    }
+    const double persistent = seconds() - t;
+
+    std::printf("versions   n=%-9d versions=%-6d MyDeque copy %9.4fs  PersistentDeque %9.4fs\n", n, versions, copying, persistent);}
+
+// ----
+// scan
+// ----
+
+/**
+ * Whole-deque scans through the index iterator vs the row-at-a-time kernels.
+ */
+void bench_scan (int n, int reps) {
+    MyDeque<int> x(n, 1);
+    MyDeque<int> y(x);
+    const MyDeque<int>& cx = x;
+    long r = 0;
+
+    double t = seconds();
+    for (int i = 0; i != reps; ++i)
+        r += std::count(cx.begin(), cx.end(), 2) + std::accumulate(cx.begin(), cx.end(), 0) + (std::find(cx.begin(), cx.end(), 2) == cx.end()) + std::equal(cx.begin(), cx.end(), y.begin());
+    const double iterating = seconds() - t;
+
+    t = seconds();
+    for (int i = 0; i != reps; ++i)
+        r += count(cx, 2) + sum(cx) + (find(cx, 2) == cx.end()) + (cx == y);
+    const double kernels = seconds() - t;
+    sink = r;
+
+    std::printf("scan       n=%-9d reps=%-10d iterator     %9.4fs  kernels         %9.4fs\n", n, reps, iterating, kernels);}
+
+// ------
+// window
+// ------
+
+/**
+ * Slides a window of n samples, reading min, max and sum after each tick:
+ * rescanning the MyDeque for rescans ticks vs SlidingWindow for ticks
+ * ticks, reported per tick. SlidingWindow's occasional O(n) flip only
+ * amortizes to O(1) over n or more ticks, so ticks should be at least n.
+ */
+void bench_window (int n, int rescans, int ticks) {
+    MyDeque<long> x;
+    SlidingWindow<long> w;
+    for (int i = 0; i != n; ++i) {
+        x.push_back(i);
+        w.push_back(i);}
+    long r = 0;
+
+    double t = seconds();
+    for (int i = 0; i != rescans; ++i) {
+        x.push_back(n + i);
+        x.pop_front();
+        r += min(x) + max(x) + sum(x);}
+    const double rescanning = (seconds() - t) / rescans;
+
+    t = seconds();
+    for (int i = 0; i != ticks; ++i) {
+        w.push_back(n + i);
+        w.pop_front();
+        r += w.min() + w.max() + w.aggregate();}
+    const double sliding = (seconds() - t) / ticks;
+    sink = r;
+
+    std::printf("window     n=%-9d ticks=%-9d rescan %11.1fns/tick  SlidingWindow %9.1fns/tick\n", n, ticks, rescanning * 1e9, sliding * 1e9);}
+
+// -------
+// columns
+// -------
+
+struct Record {
+    double f[8];};
+
+/**
+ * Sums one field of n eight-field records: MyDeque of structs vs ColumnarDeque.
+ */
+void bench_columns (int n, int reps) {
+    typedef ColumnarDeque<double, double, double, double, double, double, double, double> C;
+    Record r = {{1, 2, 3, 4, 5, 6, 7, 8}};
+    MyDeque<Record> x;
+    C y;
+    for (int i = 0; i != n; ++i) {
+        x.push_back(r);
+        y.push_back(C::value_type(1, 2, 3, 4, 5, 6, 7, 8));}
+    const MyDeque<Record>& cx = x;
+    const C& cy = y;
+    double s = 0;
+
+    double t = seconds();
+    for (int k = 0; k != reps; ++k)
+        for (int i = 0; i != n; ++i)
+            s += cx[i].f[2];
+    const double rows = seconds() - t;
+
+    t = seconds();
+    for (int k = 0; k != reps; ++k)
+        s += sum(cy.column<2>());
+    const double columns = seconds() - t;
+    sink = long(s);
+
+    std::printf("columns    n=%-9d reps=%-10d MyDeque<Record> %6.4fs  ColumnarDeque   %9.4fs\n", n, reps, rows, columns);}
+
+// ------
+// blocks
+// ------
+
+/**
+ * Sums n elements with the row-at-a-time kernels, for a deque built a row
+ * at a time by push_back and for one held in a single row, then once
+ * through the iterator, then reads n random indices. With a huge-page
+ * BlockAllocator both the small rows and the single row sit on 2 MB pages,
+ * which shows most in the random reads.
+ */
+template <typename A>
+void bench_blocks (const char* name, int n, int reps) {
+    MyDeque<int, A> x;
+    for (int i = 0; i != n; ++i)
+        x.push_back(i & 1);
+    MyDeque<int, A> y(n, 1);
+    long r = 0;
+
+    // each rep writes an element, so that the sum cannot be hoisted out of the loop
+    double t = seconds();
+    for (int i = 0; i != reps; ++i) {
+        x[i] = 2;
+        r += sum(x);}
+    const double rows = seconds() - t;
+
+    t = seconds();
+    for (int i = 0; i != reps; ++i) {
+        y[i] = 2;
+        r += sum(y);}
+    const double row = seconds() - t;
+
+    t = seconds();
+    r += std::accumulate(x.begin(), x.end(), 0L);
+    const double iterating = seconds() - t;
+
+    std::vector<int> k(n);
+    unsigned u = 1;
+    for (int i = 0; i != n; ++i) {
+        u = u * 1664525 + 1013904223;
+        k[i] = int(u % unsigned(n));}
+    t = seconds();
+    for (int i = 0; i != n; ++i)
+        r += x[k[i]];
+    const double indexing = seconds() - t;
+    sink = r;
+
+    std::printf("blocks     n=%-9d reps=%-4d %-19s rows %7.4fs  one row %7.4fs  iterator %7.4fs  random [] %7.4fs\n", n, reps, name, rows, row, iterating, indexing);}
+
+// --------
+// pipeline
+// --------
+
+/**
+ * The mutex and condition variable around a MyDeque that a stage blocks on.
+ */
+class BlockingQueue {
+    private:
+        Mutex _m;
+        Condition _c;
+        MyDeque<int> _x;
+        std::size_t _capacity;
+
+    public:
+        explicit BlockingQueue (std::size_t capacity) : _capacity(capacity) {}
+
+        void push_back (int v) {
+            Lock l(_m);
+            while (_x.size() == _capacity)
+                _c.wait(_m);
+            _x.push_back(v);
+            _c.broadcast();}
+
+        int pop_front () {
+            Lock l(_m);
+            while (_x.empty())
+                _c.wait(_m);
+            const int v = _x.front();
+            _x.pop_front();
+            _c.broadcast();
+            return v;}};
+
+struct BlockingStage {
+    BlockingQueue* in;
+    BlockingQueue* out;
+    int n;};
+
+void* run_blocking (void* p) {
+    const BlockingStage& s = *static_cast<BlockingStage*>(p);
+    for (int i = 0; i != s.n; ++i)
+        s.out->push_back(s.in->pop_front() + 1);
+    return 0;}
+
+// pops n values from in and pushes each one plus one onto out; with no in
+// it pushes 0, 1, ..., n - 1 and with no out it adds the values to sum
+struct AsyncStage : Task {
+    AsyncDeque<int>* in;
+    AsyncDeque<int>* out;
+    int v;
+    int n;
+    long sum;
+    bool popped;
+
+    void run () {
+        if (popped) {
+            popped = false;
+            --n;
+            if (out)
+                out->push_back(v + 1, this);
+            else {
+                sum += v;
+                run();}}
+        else if (n) {
+            popped = true;
+            if (in)
+                in->pop_front(v, this);
+            else {
+                v = n - 1;
+                run();}}}};
+
+/**
+ * Passes n values through a chain of stages: a thread blocked per stage vs
+ * AsyncDeque stages sharing a pool of threads.
+ */
+void bench_pipeline (int stages, int n, int threads) {
+    long r = 0;
+
+    double t = seconds();
+    {
+    std::vector<BlockingQueue*> qs;
+    for (int i = 0; i != stages + 1; ++i)
+        qs.push_back(new BlockingQueue(16));
+    std::vector<BlockingStage> ss(stages);
+    std::vector<pthread_t> ts(stages);
+    for (int i = 0; i != stages; ++i) {
+        BlockingStage s = {qs[i], qs[i + 1], n};
+        ss[i] = s;
+        pthread_create(&ts[i], 0, run_blocking, &ss[i]);}
+    for (int i = 0; i != n; ++i) {
+        qs.front()->push_back(i);
+        if (i >= 15)
+            r += qs.back()->pop_front();}
+    for (int i = std::max(n - 15, 0); i != n; ++i)
+        r += qs.back()->pop_front();
+    for (int i = 0; i != stages; ++i)
+        pthread_join(ts[i], 0);
+    for (int i = 0; i != stages + 1; ++i)
+        delete qs[i];
+    }
+    const double blocking = seconds() - t;
+
+    t = seconds();
+    {
+    ThreadPoolExecutor x(threads);
+    std::vector< AsyncDeque<int>* > qs;
+    for (int i = 0; i != stages + 1; ++i)
+        qs.push_back(new AsyncDeque<int>(x, 16));
+    std::vector<AsyncStage> ss(stages + 2);
+    for (int i = 0; i != stages + 2; ++i) {
+        ss[i].in = i ? qs[i - 1] : 0;
+        ss[i].out = (i != stages + 1) ? qs[i] : 0;
+        ss[i].n = n;
+        ss[i].sum = 0;
+        ss[i].popped = false;}
+    for (int i = 0; i != stages + 2; ++i)
+        x.post(&ss[i]);
+    x.wait();
+    r += ss.back().sum;
+    for (int i = 0; i != stages + 1; ++i)
+        delete qs[i];
+    }
+    const double async = seconds() - t;
+    sink = r;
+
+    std::printf("pipeline   stages=%-6d n=%-12d thread per stage %7.4fs  AsyncDeque x%d %9.4fs\n", stages, n, blocking, threads, async);}
+
+// -----
+// drain
+// -----
+
+/**
+ * Empties a deque of n elements into a buffer: front() and pop_front()
+ * one element at a time vs drain_front a batch at a time.
+ */
+void bench_drain (int n, int batch, int reps) {
+    std::vector<int> v(batch);
+    long r = 0;
+    double popping = 0;
+    double draining = 0;
+    for (int k = 0; k != reps; ++k) {
+        MyDeque<int> x;
+        for (int i = 0; i != n; ++i)
+            x.push_back(i);
+        MyDeque<int> y(x);
+
+        double t = seconds();
+        while (!x.empty()) {
+            int j = 0;
+            for (; (j != batch) && !x.empty(); ++j) {
+                v[j] = x.front();
+                x.pop_front();}
+            r += v[j - 1];}
+        popping += seconds() - t;
+
+        t = seconds();
+        while (!y.empty())
+            r += *(y.drain_front(batch, &v[0]) - 1);
+        draining += seconds() - t;}
+    sink = r;
+
+    std::printf("drain      n=%-9d batch=%-9d pop_front    %9.4fs  drain_front     %9.4fs\n", n, batch, popping, draining);}
+
+// -----
+// flags
+// -----
+
+/**
+ * Counts the set flags among n, and finds the first clear one, in a byte
+ * per flag std::deque<bool> vs the bit-packed MyDeque<bool>.
+ */
+void bench_flags (int n, int reps) {
+    std::deque<bool> x;
+    MyDeque<bool> y;
+    for (int i = 0; i != n; ++i) {
+        x.push_back(i != n - 1);
+        y.push_back(i != n - 1);}
+    long r = 0;
+
+    double t = seconds();
+    for (int i = 0; i != reps; ++i)
+        r += std::count(x.begin(), x.end(), true) + (std::find(x.begin(), x.end(), false) - x.begin());
+    const double bytes = seconds() - t;
+
+    t = seconds();
+    for (int i = 0; i != reps; ++i)
+        r += y.count() + y.find_first(false);
+    const double bits = seconds() - t;
+    sink = r;
+
+    std::printf("flags      n=%-9d reps=%-10d std::deque<bool> %5.4fs  MyDeque<bool> %11.4fs  (%d vs %d bytes)\n", n, reps, bytes, bits, n, int(y.words().size() * sizeof(MyDeque<bool>::word)));}
+
+// ----
+// swap
+// ----
+
+/**
+ * An allocator that is equal only to copies of itself, like a per-thread
+ * pool, so that MyDeques of different workers do not compare equal.
+ */
+template <typename T>
+struct Tagged : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        typedef Tagged<U> other;};
+
+    int id;
+
+    explicit Tagged (int i = 0) : id(i) {}
+
+    template <typename U>
+    Tagged (const Tagged<U>& that) : std::allocator<T>(), id(that.id) {}
+
+    bool operator == (const Tagged& that) const {
+        return id == that.id;}};
+
+/**
+ * Swaps and assigns deques of n and n / 2 elements: with equal allocators,
+ * with unequal ones, and the copy, assign, assign a swap used to cost
+ * between unequal allocators; then assignment that reuses the elements
+ * vs clear() and resize() followed by copy.
+ */
+void bench_swap (int n, int reps) {
+    typedef MyDeque< int, Tagged<int> > D;
+    D x(Tagged<int>(1));
+    D y(Tagged<int>(1));
+    D z(Tagged<int>(2));
+    for (int i = 0; i != n; ++i) {
+        x.push_back(i);
+        if (i & 1) {
+            y.push_back(i);
+            z.push_back(i);}}
+
+    double t = seconds();
+    for (int i = 0; i != reps; ++i)
+        x.swap(y);
+    const double same = seconds() - t;
+
+    t = seconds();
+    for (int i = 0; i != reps; ++i)
+        x.swap(z);
+    const double different = seconds() - t;
+
+    t = seconds();
+    for (int i = 0; i != reps; ++i) {
+        D w(x);
+        x = z;
+        z = w;}
+    const double copies = seconds() - t;
+
+    D a(Tagged<int>(3));
+    t = seconds();
+    for (int i = 0; i != reps; ++i) {
+        a = x;
+        a = z;}
+    const double reusing = seconds() - t;
+
+    D b(Tagged<int>(3));
+    t = seconds();
+    for (int i = 0; i != reps; ++i) {
+        b.clear();
+        b.resize(x.size());
+        std::copy(x.begin(), x.end(), b.begin());
+        b.clear();
+        b.resize(z.size());
+        std::copy(z.begin(), z.end(), b.begin());}
+    const double resizing = seconds() - t;
+    sink = a.back() + b.back();
+
+    std::printf("swap       n=%-9d reps=%-6d same allocator %9.6fs  different %9.4fs  3 copies %9.4fs\n", n, reps, same, different, copies);
+    std::printf("assign     n=%-9d reps=%-6d reusing elements %7.4fs  clear+resize+copy %9.4fs\n", n, reps, reusing, resizing);}
+
+// ----
+// main
+// ----
+
+int main () {
+    bench_versions(1000, 1000);
+    bench_versions(10000, 1000);
+    bench_versions(100000, 100);
+    bench_scan(1000000, 20);
+    bench_window(1000, 100000, 100000);
+    bench_window(100000, 1000, 1000000);
+    bench_window(10000000, 10, 20000000);
+    bench_columns(1000000, 10);
+    bench_blocks< std::allocator<int> >("std::allocator", 10000000, 50);
+    bench_blocks< BlockAllocator<int> >("BlockAllocator", 10000000, 50);
+    bench_blocks< BlockAllocator<int, transparent_huge_pages> >("BlockAllocator THP", 10000000, 50);
+    bench_drain(10000000, 1000, 5);
+    bench_flags(10000000, 10);
+    bench_swap(1000000, 50);
+    bench_pipeline(10, 100000, 2);
+    bench_pipeline(1000, 1000, 2);
+    return 0;}
@@ -0,0 +1,348 @@
+// -------------------------------
+// projects/deque/BenchLatency.c++
+// Copyright (C) 2012
+// Glenn P. Downing
+// -------------------------------
+
+/*
+To run the benchmark:
+% g++ -ansi -pedantic -Wall -O2 -DNDEBUG BenchLatency.c++ -o BenchLatency.c++.app
+% BenchLatency.c++.app [-n ops] [-r ratio] [-t ns] [-v]
+
+Times every operation on its own and prints p50, p99, p99.9 and max in
+nanoseconds for MyDeque and std::deque, less the median cost of timing
+nothing. -v adds a histogram per row.
+With -r the run fails if a MyDeque p99.9 is more than ratio times the
+std::deque p99.9 for the same row; with -t it fails if a MyDeque p99.9
+is more than ns. The exit status is 0 on a pass, 1 on a failure and 2 on
+a bad argument, so that a build can gate on tail latency.
+*/
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // sort
+#include <cstdio> // printf
+#include <cstdlib> // atof, atoi, rand, srand
+#include <cstring> // strcmp
+#include <deque> // deque
+#include <stdint.h> // uint64_t
+#include <time.h> // clock_gettime
+#include <vector> // vector
+
+#include "Deque.h"
+
+// -----
+// ticks
+// -----
+
+/**
+ * The lfences keep rdtsc from being reordered with the work on either
+ * side of it, so that a sample covers exactly the operation timed.
+ * @return a reading of the time stamp counter on x86, or of the monotonic clock in ns elsewhere
+ */
+inline uint64_t ticks () {
+#if defined(__GNUC__) && defined(__SSE2__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_lfence();
+    const uint64_t t = __builtin_ia32_rdtsc();
+    __builtin_ia32_lfence();
+    return t;
+#else
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return uint64_t(t.tv_sec) * 1000000000 + t.tv_nsec;
+#endif
+    }
+
+/**
+ * @return the nanoseconds per tick, measured against the monotonic clock
+ */
+double calibrate () {
+    timespec a;
+    timespec b;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    const uint64_t t = ticks();
+    do
+        clock_gettime(CLOCK_MONOTONIC, &b);
+    while ((b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec) < 5e7);
+    const uint64_t u = ticks();
+    return ((b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec)) / double(u - t);}
+
+// ----
+// sink
+// ----
+
+// keeps the optimizer from discarding the work being timed
+volatile long sink;
+
+// -------
+// Samples
+// -------
+
+/**
+ * The latencies of one kind of operation, in ticks, less the cost of
+ * taking the two readings around it.
+ */
+class Samples {
+    private:
+        std::vector<uint64_t> _s;
+        uint64_t _overhead;
+        bool _sorted;
+
+    public:
+        /**
+	 * @param n the number of samples to make room for
+	 * @param overhead the ticks to subtract from every sample
+	 */
+        explicit Samples (int n, uint64_t overhead = 0) : _overhead(overhead), _sorted(false) {
+            _s.reserve(n);}
+
+        void add (uint64_t t) {
+            _s.push_back(t > _overhead ? t - _overhead : 0);
+            _sorted = false;}
+
+        /**
+	 * @param q in [0, 1]
+	 * @return the qth quantile in ticks
+	 */
+        uint64_t quantile (double q) {
+            if (_s.empty())
+                return 0;
+            if (!_sorted) {
+                std::sort(_s.begin(), _s.end());
+                _sorted = true;}
+            const std::size_t i = std::size_t(q * _s.size());
+            return _s[std::min(i, _s.size() - 1)];}
+
+        /**
+	 * prints how many samples fall in each power-of-two bucket of ns
+	 */
+        void histogram (double ns) const {
+            std::vector<int> b(64);
+            for (std::size_t i = 0; i != _s.size(); ++i) {
+                int k = 0;
+                while ((k != 63) && ((uint64_t(1) << k) < _s[i] * ns))
+                    ++k;
+                ++b[k];}
+            for (int k = 0; k != 64; ++k)
+                if (b[k])
+                    std::printf("    <= %12.0f ns %10d\n", double(uint64_t(1) << k), b[k]);}};
+
+// ----
+// TIME
+// ----
+
+/**
+ * Times the expression e into the Samples s.
+ */
+#define TIME(s, e)                       \
+    do {                                 \
+        const uint64_t t0_ = ticks();    \
+        e;                               \
+        (s).add(ticks() - t0_);}         \
+    while (0)
+
+// --------
+// overhead
+// --------
+
+/**
+ * @return the median ticks of an empty TIME, to be subtracted from every sample
+ */
+uint64_t overhead () {
+    Samples s(100000);
+    for (int i = 0; i != 100000; ++i)
+        TIME(s, sink = i);
+    return s.quantile(0.5);}
+
+// ---------
+// scenarios
+// ---------
+
+/**
+ * The operations and growth patterns that are timed, for a container C.
+ */
+template <typename C>
+struct Scenarios {
+    // push_back onto an empty deque until it has n elements
+    static void push_back_grow (int n, Samples& s) {
+        C x;
+        for (int i = 0; i != n; ++i)
+            TIME(s, x.push_back(i));
+        sink = x.back();}
+
+    // push_front onto an empty deque until it has n elements
+    static void push_front_grow (int n, Samples& s) {
+        C x;
+        for (int i = 0; i != n; ++i)
+            TIME(s, x.push_front(i));
+        sink = x.front();}
+
+    // push_back and push_front in turn, n in all
+    static void push_both_grow (int n, Samples& s) {
+        C x;
+        for (int i = 0; i != n; ++i)
+            if (i & 1)
+                TIME(s, x.push_front(i));
+            else
+                TIME(s, x.push_back(i));
+        sink = x.front();}
+
+    // push_back onto a deque that already has n elements, n times
+    static void push_back_presized (int n, Samples& s) {
+        C x(n);
+        for (int i = 0; i != n; ++i)
+            TIME(s, x.push_back(i));
+        sink = x.back();}
+
+    // pop_back a deque of n elements until it is empty
+    static void pop_back_drain (int n, Samples& s) {
+        C x;
+        for (int i = 0; i != n; ++i)
+            x.push_back(i);
+        for (int i = 0; i != n; ++i)
+            TIME(s, x.pop_back());
+        sink = x.size();}
+
+    // pop_front a deque of n elements until it is empty
+    static void pop_front_drain (int n, Samples& s) {
+        C x;
+        for (int i = 0; i != n; ++i)
+            x.push_back(i);
+        for (int i = 0; i != n; ++i)
+            TIME(s, x.pop_front());
+        sink = x.size();}
+
+    // push_back then pop_front on a queue of 1000 elements, n times each
+    static void queue_steady (int n, Samples& s) {
+        C x;
+        for (int i = 0; i != 1000; ++i)
+            x.push_back(i);
+        for (int i = 0; i != n; ++i) {
+            TIME(s, x.push_back(i));
+            TIME(s, x.pop_front());}
+        sink = x.size();}
+
+    // grows to n / 10 elements and back to empty, again and again
+    static void sawtooth (int n, Samples& s) {
+        C x;
+        const int m = std::max(n / 10, 1);
+        for (int k = 0; k != 5; ++k) {
+            for (int i = 0; i != m; ++i)
+                TIME(s, x.push_back(i));
+            for (int i = 0; i != m; ++i)
+                TIME(s, x.pop_front());}
+        sink = x.size();}
+
+    // resize by 64 elements at a time up to n / 10 and back to empty, again and again
+    static void resize_sawtooth (int n, Samples& s) {
+        C x;
+        const int m = std::max(n / 10, 64);
+        for (int k = 0; k != 5; ++k) {
+            for (int i = 64; i <= m; i += 64)
+                TIME(s, x.resize(i));
+            for (int i = m / 64 * 64 - 64; i >= 0; i -= 64)
+                TIME(s, x.resize(i));}
+        sink = x.size();}
+
+    // operator [] at random indices of a deque of n elements
+    static void index_random (int n, Samples& s) {
+        C x;
+        for (int i = 0; i != n; ++i)
+            x.push_back(i);
+        std::vector<int> k(n);
+        std::srand(0);
+        for (int i = 0; i != n; ++i)
+            k[i] = std::rand() % n;
+        long r = 0;
+        for (int i = 0; i != n; ++i)
+            TIME(s, r += x[k[i]]);
+        sink = r;}
+
+    // insert into the middle of a deque that grows from n / 100 elements
+    static void insert_middle (int n, Samples& s) {
+        C x;
+        const int m = std::max(n / 100, 1);
+        for (int i = 0; i != m; ++i)
+            x.push_back(i);
+        for (int i = 0; i != m; ++i)
+            TIME(s, x.insert(x.begin() + int(x.size() / 2), i));
+        sink = x.size();}};
+
+// ---
+// Row
+// ---
+
+struct Row {
+    const char* name;
+    void (*mine) (int, Samples&);
+    void (*theirs) (int, Samples&);};
+
+// ----
+// main
+// ----
+
+int main (int argc, char* argv[]) {
+    int n = 1000000;
+    double ratio = 0;
+    double limit = 0;
+    bool verbose = false;
+    for (int i = 1; i != argc; ++i) {
+        if (!std::strcmp(argv[i], "-v"))
+            verbose = true;
+        else if ((i + 1 == argc) || (argv[i][0] != '-') || !argv[i][1] || argv[i][2]) {
+            std::printf("usage: %s [-n ops] [-r ratio] [-t ns] [-v]\n", argv[0]);
+            return 2;}
+        else if (argv[i][1] == 'n')
+            n = std::atoi(argv[++i]);
+        else if (argv[i][1] == 'r')
+            ratio = std::atof(argv[++i]);
+        else if (argv[i][1] == 't')
+            limit = std::atof(argv[++i]);
+        else {
+            std::printf("usage: %s [-n ops] [-r ratio] [-t ns] [-v]\n", argv[0]);
+            return 2;}}
+    if (n <= 0) {
+        std::printf("%s: -n must be positive\n", argv[0]);
+        return 2;}
+
+    typedef Scenarios< MyDeque<int> > M;
+    typedef Scenarios< std::deque<int> > S;
+    const Row rows[] = {
+        {"push_back   grow",     M::push_back_grow,     S::push_back_grow},
+        {"push_front  grow",     M::push_front_grow,    S::push_front_grow},
+        {"push both   grow",     M::push_both_grow,     S::push_both_grow},
+        {"push_back   presized", M::push_back_presized, S::push_back_presized},
+        {"pop_back    drain",    M::pop_back_drain,     S::pop_back_drain},
+        {"pop_front   drain",    M::pop_front_drain,    S::pop_front_drain},
+        {"push/pop    queue",    M::queue_steady,       S::queue_steady},
+        {"push/pop    sawtooth", M::sawtooth,           S::sawtooth},
+        {"resize      sawtooth", M::resize_sawtooth,    S::resize_sawtooth},
+        {"operator [] random",   M::index_random,       S::index_random},
+        {"insert      middle",   M::insert_middle,      S::insert_middle}};
+
+    const double ns = calibrate();
+    const uint64_t o = overhead();
+    int failures = 0;
+    std::printf("%-22s %-12s %10s %10s %10s %12s  (ns, n=%d, less %.0f ns per empty TIME)\n", "operation", "container", "p50", "p99", "p99.9", "max", n, o * ns);
+    for (std::size_t r = 0; r != sizeof(rows) / sizeof(rows[0]); ++r) {
+        Samples mine(2 * n, o);
+        Samples theirs(2 * n, o);
+        rows[r].mine(n, mine);
+        rows[r].theirs(n, theirs);
+        const double m999 = mine.quantile(0.999) * ns;
+        const double t999 = theirs.quantile(0.999) * ns;
+        std::printf("%-22s %-12s %10.0f %10.0f %10.0f %12.0f\n", rows[r].name, "MyDeque", mine.quantile(0.5) * ns, mine.quantile(0.99) * ns, m999, mine.quantile(1) * ns);
+        if (verbose)
+            mine.histogram(ns);
+        std::printf("%-22s %-12s %10.0f %10.0f %10.0f %12.0f\n", "", "std::deque", theirs.quantile(0.5) * ns, theirs.quantile(0.99) * ns, t999, theirs.quantile(1) * ns);
+        if (verbose)
+            theirs.histogram(ns);
+        if ((ratio > 0) && (m999 > ratio * t999)) {
+            std::printf("FAIL %s: MyDeque p99.9 %.0f ns is more than %g times std::deque's %.0f ns\n", rows[r].name, m999, ratio, t999);
+            ++failures;}
+        if ((limit > 0) && (m999 > limit)) {
+            std::printf("FAIL %s: MyDeque p99.9 %.0f ns is more than %g ns\n", rows[r].name, m999, limit);
+            ++failures;}}
+    return failures ? 1 : 0;}
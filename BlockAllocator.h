@@ -0,0 +1,407 @@
+// -------------------------------
+// projects/deque/BlockAllocator.h
+// Copyright (C) 2012
+// Glenn P. Downing
+// -------------------------------
+
+#ifndef BlockAllocator_h
+#define BlockAllocator_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // ptrdiff_t, size_t
+#include <cstdlib> // free
+#include <limits> // numeric_limits
+#include <map> // map
+#include <new> // bad_alloc, placement new
+#include <pthread.h> // pthread_mutex_t
+#include <stdlib.h> // posix_memalign
+#include <sys/mman.h> // madvise, mmap, munmap
+#include <utility> // make_pair
+
+// ----------
+// huge_pages
+// ----------
+
+/**
+ * how a BlockAllocator backs its allocations
+ */
+enum huge_pages {
+    no_huge_pages,          // posix_memalign
+    transparent_huge_pages, // 2 MB aligned mmap, then madvise(MADV_HUGEPAGE)
+    explicit_huge_pages};   // mmap(MAP_HUGETLB), falling back to transparent
+
+// ------------
+// HugePagePool
+// ------------
+
+/**
+ * Blocks of up to maxBlock bytes cut from 2 MB arenas mapped on huge pages,
+ * so that the many small rows of a MyDeque, not only the rare row of 2 MB
+ * or more, sit on huge pages. An arena serves one power-of-two size class
+ * and keeps a free list threaded through its free blocks and a count of
+ * the ones in use; a block is aligned to its class size. When the last
+ * block of an arena is freed the arena is unmapped, unless it is the only
+ * arena of its class with free blocks, so each class holds on to at most
+ * one idle arena and a deque that grows and shrinks across a row does not
+ * map and unmap on every push. The pool is shared by every BlockAllocator
+ * with policy H, whatever its T.
+ */
+template <int H>
+class HugePagePool {
+    public:
+        enum {hugePageSize = 2 * 1024 * 1024};
+        enum {minBlock = 64};
+        enum {maxBlock = hugePageSize / 2};
+
+    private:
+        // minBlock << (classes - 1) == maxBlock
+        enum {classes = 15};
+
+        struct Block {
+            Block* next;};
+
+        struct Arena {
+            char* base;
+            Block* free;
+            std::size_t live;
+            // neighbours in _partial of its class
+            Arena* prev;
+            Arena* next;};
+
+        typedef std::map<char*, Arena*> arena_map;
+
+        static pthread_mutex_t _m;
+
+        // the arenas of each class that have a free block
+        static Arena* _partial[classes];
+
+        /**
+	 * @return the size class of a block of bytes
+	 */
+        static int size_class (std::size_t bytes) {
+            int c = 0;
+            while ((std::size_t(minBlock) << c) < bytes)
+                ++c;
+            return c;}
+
+        /**
+	 * @return every arena by its base, which is never destroyed so that
+	 *         blocks can still be freed during static destruction
+	 */
+        static arena_map& arenas () {
+            static arena_map* const a = new arena_map;
+            return *a;}
+
+        static void link (int c, Arena* a) {
+            a->prev = 0;
+            a->next = _partial[c];
+            if (a->next)
+                a->next->prev = a;
+            _partial[c] = a;}
+
+        static void unlink (int c, Arena* a) {
+            if (a->prev)
+                a->prev->next = a->next;
+            else
+                _partial[c] = a->next;
+            if (a->next)
+                a->next->prev = a->prev;}
+
+        /**
+	 * maps an arena for class c and cuts it into blocks
+	 * @throw bad_alloc if there is no memory
+	 */
+        static Arena* new_arena (int c) {
+            char* const p = static_cast<char*>(map(hugePageSize));
+            Arena* a = 0;
+            try {
+                a = new Arena;
+                arenas().insert(std::make_pair(p, a));}
+            catch (...) {
+                delete a;
+                unmap(p, hugePageSize);
+                throw;}
+            a->base = p;
+            a->free = 0;
+            a->live = 0;
+            const std::size_t s = std::size_t(minBlock) << c;
+            for (std::size_t i = hugePageSize; i != 0; i -= s) {
+                Block* const b = reinterpret_cast<Block*>(p + i - s);
+                b->next = a->free;
+                a->free = b;}
+            link(c, a);
+            return a;}
+
+    public:
+        // ---
+        // map
+        // ---
+
+        /**
+	 * @param m a multiple of hugePageSize
+	 * @return m bytes aligned to hugePageSize and advised or mapped onto huge pages
+	 * @throw bad_alloc if there is no memory
+	 */
+        static void* map (std::size_t m) {
+#ifdef MAP_HUGETLB
+            if (H == explicit_huge_pages) {
+                // hugetlb mappings are aligned to a huge page by the kernel
+                void* const p = mmap(0, m, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (p != MAP_FAILED)
+                    return p;}
+#endif
+            // mmap only aligns to a page, so map a huge page more and trim both ends
+            void* const p = mmap(0, m + hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED)
+                throw std::bad_alloc();
+            char* const q = static_cast<char*>(p);
+            const std::size_t head = (hugePageSize - reinterpret_cast<std::size_t>(q) % hugePageSize) % hugePageSize;
+            if (head)
+                munmap(q, head);
+            munmap(q + head + m, hugePageSize - head);
+#ifdef MADV_HUGEPAGE
+            madvise(q + head, m, MADV_HUGEPAGE);
+#endif
+            return q + head;}
+
+        // -----
+        // unmap
+        // -----
+
+        static void unmap (void* p, std::size_t m) {
+            munmap(p, m);}
+
+        // --------
+        // allocate
+        // --------
+
+        /**
+	 * @param bytes at most maxBlock
+	 * @return a block of at least bytes, aligned to its size class
+	 * @throw bad_alloc if a new arena cannot be mapped
+	 */
+        static void* allocate (std::size_t bytes) {
+            const int c = size_class(bytes);
+            pthread_mutex_lock(&_m);
+            Arena* a = _partial[c];
+            if (!a) {
+                try {
+                    a = new_arena(c);}
+                catch (...) {
+                    pthread_mutex_unlock(&_m);
+                    throw;}}
+            Block* const b = a->free;
+            a->free = b->next;
+            ++a->live;
+            if (!a->free)
+                unlink(c, a);
+            pthread_mutex_unlock(&_m);
+            return b;}
+
+        // ----------
+        // deallocate
+        // ----------
+
+        /**
+	 * @param p a block returned by allocate(bytes)
+	 * @param bytes the size it was allocated for
+	 */
+        static void deallocate (void* p, std::size_t bytes) {
+            const int c = size_class(bytes);
+            Block* const b = static_cast<Block*>(p);
+            char* const base = static_cast<char*>(p) - reinterpret_cast<std::size_t>(p) % hugePageSize;
+            pthread_mutex_lock(&_m);
+            Arena* const a = arenas().find(base)->second;
+            if (!a->free)
+                link(c, a);
+            b->next = a->free;
+            a->free = b;
+            if (!--a->live && (a->prev || a->next)) {
+                unlink(c, a);
+                arenas().erase(base);
+                delete a;
+                unmap(base, hugePageSize);}
+            pthread_mutex_unlock(&_m);}
+
+        // -----------
+        // arena_count
+        // -----------
+
+        /**
+	 * @return the number of arenas mapped
+	 */
+        static std::size_t arena_count () {
+            pthread_mutex_lock(&_m);
+            const std::size_t n = arenas().size();
+            pthread_mutex_unlock(&_m);
+            return n;}};
+
+template <int H>
+pthread_mutex_t HugePagePool<H>::_m = PTHREAD_MUTEX_INITIALIZER;
+
+template <int H>
+typename HugePagePool<H>::Arena* HugePagePool<H>::_partial[classes];
+
+// --------------
+// BlockAllocator
+// --------------
+
+/**
+ * An allocator for MyDeque's rows and outer array. Every allocation is
+ * aligned to a cache line, so a row never shares a line with another and
+ * its first element starts one. With a huge-page policy, allocations of up
+ * to HugePagePool::maxBlock bytes are cut from the pool's 2 MB arenas and
+ * larger ones are mapped on their own, so that the rows of a deque grown
+ * by push_back sit on huge pages, which cuts TLB misses when scanning or
+ * indexing. A pool block is only ever reused for its own size class, and
+ * the pool keeps up to one idle arena per class mapped, so a program that
+ * frees many blocks of one size and then allocates another can hold up to
+ * 30 MB more than it uses. The policy is part of the type so that it carries over to the
+ * rebound outer allocator.
+ */
+template <typename T, int H = no_huge_pages>
+class BlockAllocator {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef T value_type;
+
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        typedef T* pointer;
+        typedef const T* const_pointer;
+
+        typedef T& reference;
+        typedef const T& const_reference;
+
+        template <typename U>
+        struct rebind {
+            typedef BlockAllocator<U, H> other;};
+
+        enum {cacheLineSize = 64};
+        enum {hugePageSize = HugePagePool<H>::hugePageSize};
+
+    public:
+        // -----------
+        // operator ==
+        // -----------
+
+        /**
+	 * @return true; any two BlockAllocators can free each other's memory
+	 */
+        friend bool operator == (const BlockAllocator&, const BlockAllocator&) {
+            return true;}
+
+        friend bool operator != (const BlockAllocator&, const BlockAllocator&) {
+            return false;}
+
+    private:
+        // ------
+        // mapped
+        // ------
+
+        /**
+	 * @return the number of bytes to map for n elements on their own, or 0
+	 *         if they come from posix_memalign or the pool
+	 */
+        static size_type mapped (size_type n) {
+            const size_type bytes = n * sizeof(T);
+            if ((H == no_huge_pages) || (bytes <= size_type(HugePagePool<H>::maxBlock)))
+                return 0;
+            return (bytes + hugePageSize - 1) / hugePageSize * hugePageSize;}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        BlockAllocator () {}
+
+        template <typename U>
+        BlockAllocator (const BlockAllocator<U, H>&) {}
+
+        // Default copy, destructor, and copy assignment.
+        // BlockAllocator (const BlockAllocator&);
+        // ~BlockAllocator ();
+        // BlockAllocator& operator = (const BlockAllocator&);
+
+        // -------
+        // address
+        // -------
+
+        pointer address (reference x) const {
+            return &x;}
+
+        const_pointer address (const_reference x) const {
+            return &x;}
+
+        // --------
+        // allocate
+        // --------
+
+        /**
+	 * @param n the number of elements
+	 * @return uninitialized space for n elements, aligned to a cache line;
+	 *         with a huge-page policy, to its power-of-two size class if it
+	 *         comes from the pool, or to a huge page if it is mapped
+	 * @throw bad_alloc if there is no memory
+	 */
+        pointer allocate (size_type n, const void* = 0) {
+            if (n > max_size())
+                throw std::bad_alloc();
+            if (H == no_huge_pages) {
+                void* p = 0;
+                if (posix_memalign(&p, cacheLineSize, n ? n * sizeof(T) : 1))
+                    throw std::bad_alloc();
+                return static_cast<pointer>(p);}
+            const size_type m = mapped(n);
+            if (!m)
+                return static_cast<pointer>(HugePagePool<H>::allocate(n * sizeof(T)));
+            return static_cast<pointer>(HugePagePool<H>::map(m));}
+
+        // ----------
+        // deallocate
+        // ----------
+
+        /**
+	 * @param p space returned by allocate(n)
+	 * @param n the number of elements it was allocated for
+	 */
+        void deallocate (pointer p, size_type n) {
+            if (H == no_huge_pages) {
+                std::free(p);
+                return;}
+            const size_type m = mapped(n);
+            if (!m)
+                HugePagePool<H>::deallocate(p, n * sizeof(T));
+            else
+                HugePagePool<H>::unmap(p, m);}
+
+        // --------
+        // max_size
+        // --------
+
+        size_type max_size () const {
+            return std::numeric_limits<size_type>::max() / sizeof(T);}
+
+        // ---------
+        // construct
+        // ---------
+
+        void construct (pointer p, const_reference v) {
+            new (p) T(v);}
+
+        // -------
+        // destroy
+        // -------
+
+        void destroy (pointer p) {
+            p->~T();}};
+
+#endif // BlockAllocator_h
@@ -0,0 +1,534 @@
+// ------------------------------
+// projects/deque/ColumnarDeque.h
+// Copyright (C) 2012
+// Glenn P. Downing
+// ------------------------------
+
+#ifndef ColumnarDeque_h
+#define ColumnarDeque_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+
+#include "Deque.h"
+
+// ----------
+// NullColumn
+// ----------
+
+/**
+ * fills the unused field slots of a Row or ColumnarDeque
+ */
+struct NullColumn {
+    friend bool operator == (const NullColumn&, const NullColumn&) {
+        return true;}};
+
+// ---
+// Row
+// ---
+
+/**
+ * one record of a ColumnarDeque, holding up to eight fields by value
+ */
+template < typename F0, typename F1 = NullColumn, typename F2 = NullColumn, typename F3 = NullColumn,
+           typename F4 = NullColumn, typename F5 = NullColumn, typename F6 = NullColumn, typename F7 = NullColumn >
+struct Row {
+    typedef F0 type0;
+    typedef F1 type1;
+    typedef F2 type2;
+    typedef F3 type3;
+    typedef F4 type4;
+    typedef F5 type5;
+    typedef F6 type6;
+    typedef F7 type7;
+
+    F0 f0;
+    F1 f1;
+    F2 f2;
+    F3 f3;
+    F4 f4;
+    F5 f5;
+    F6 f6;
+    F7 f7;
+
+    Row (const F0& a0 = F0(), const F1& a1 = F1(), const F2& a2 = F2(), const F3& a3 = F3(),
+         const F4& a4 = F4(), const F5& a5 = F5(), const F6& a6 = F6(), const F7& a7 = F7()) :
+            f0(a0), f1(a1), f2(a2), f3(a3), f4(a4), f5(a5), f6(a6), f7(a7) {}
+
+    friend bool operator == (const Row& lhs, const Row& rhs) {
+        return (lhs.f0 == rhs.f0) && (lhs.f1 == rhs.f1) && (lhs.f2 == rhs.f2) && (lhs.f3 == rhs.f3) &&
+               (lhs.f4 == rhs.f4) && (lhs.f5 == rhs.f5) && (lhs.f6 == rhs.f6) && (lhs.f7 == rhs.f7);}};
+
+// -----------
+// ColumnStore
+// -----------
+
+/**
+ * the MyDeque behind one field; every ColumnStore of a ColumnarDeque gets
+ * the same sequence of operations, so they all share one row geometry.
+ * Fields are read through the MyDeque's const_reference, which for a
+ * packed MyDeque<bool> is a bool by value rather than a reference.
+ */
+template <typename F>
+struct ColumnStore {
+    typedef MyDeque<F> container_type;
+    typedef typename container_type::size_type size_type;
+    typedef typename container_type::const_reference const_reference;
+
+    container_type d;
+
+    ColumnStore () {}
+
+    ColumnStore (size_type s, const F& v) : d(s, v) {}
+
+    const_reference get (size_type i) const {
+        return d[i];}
+
+    void set (size_type i, const F& v) {
+        d[i] = v;}
+
+    void push_back (const F& v) {
+        d.push_back(v);}
+
+    void push_front (const F& v) {
+        d.push_front(v);}
+
+    void pop_back () {
+        d.pop_back();}
+
+    void pop_front () {
+        d.pop_front();}
+
+    void clear () {
+        d.clear();}
+
+    bool matches (size_type n) const {
+        return d.size() == n;}};
+
+/**
+ * an unused field: no storage, every operation does nothing
+ */
+template <>
+struct ColumnStore<NullColumn> {
+    typedef MyDeque<int>::size_type size_type;
+
+    ColumnStore () {}
+
+    ColumnStore (size_type, const NullColumn&) {}
+
+    NullColumn get (size_type) const {
+        return NullColumn();}
+
+    void set (size_type, const NullColumn&) {}
+
+    void push_back (const NullColumn&) {}
+
+    void push_front (const NullColumn&) {}
+
+    void pop_back () {}
+
+    void pop_front () {}
+
+    void clear () {}
+
+    bool matches (size_type) const {
+        return true;}};
+
+// ------------
+// field_access
+// ------------
+
+/**
+ * maps a field number to the Row member and the ColumnStore that hold it
+ */
+template <int I>
+struct field_access;
+
+template <>
+struct field_access<0> {
+    template <typename R> struct type {typedef typename R::type0 value;};
+    template <typename C> struct container {typedef typename C::container0 type;};
+    template <typename C> static typename C::container0& column (C& x) {return x._c0.d;}
+    template <typename C> static const typename C::container0& column (const C& x) {return x._c0.d;}};
+
+template <>
+struct field_access<1> {
+    template <typename R> struct type {typedef typename R::type1 value;};
+    template <typename C> struct container {typedef typename C::container1 type;};
+    template <typename C> static typename C::container1& column (C& x) {return x._c1.d;}
+    template <typename C> static const typename C::container1& column (const C& x) {return x._c1.d;}};
+
+template <>
+struct field_access<2> {
+    template <typename R> struct type {typedef typename R::type2 value;};
+    template <typename C> struct container {typedef typename C::container2 type;};
+    template <typename C> static typename C::container2& column (C& x) {return x._c2.d;}
+    template <typename C> static const typename C::container2& column (const C& x) {return x._c2.d;}};
+
+template <>
+struct field_access<3> {
+    template <typename R> struct type {typedef typename R::type3 value;};
+    template <typename C> struct container {typedef typename C::container3 type;};
+    template <typename C> static typename C::container3& column (C& x) {return x._c3.d;}
+    template <typename C> static const typename C::container3& column (const C& x) {return x._c3.d;}};
+
+template <>
+struct field_access<4> {
+    template <typename R> struct type {typedef typename R::type4 value;};
+    template <typename C> struct container {typedef typename C::container4 type;};
+    template <typename C> static typename C::container4& column (C& x) {return x._c4.d;}
+    template <typename C> static const typename C::container4& column (const C& x) {return x._c4.d;}};
+
+template <>
+struct field_access<5> {
+    template <typename R> struct type {typedef typename R::type5 value;};
+    template <typename C> struct container {typedef typename C::container5 type;};
+    template <typename C> static typename C::container5& column (C& x) {return x._c5.d;}
+    template <typename C> static const typename C::container5& column (const C& x) {return x._c5.d;}};
+
+template <>
+struct field_access<6> {
+    template <typename R> struct type {typedef typename R::type6 value;};
+    template <typename C> struct container {typedef typename C::container6 type;};
+    template <typename C> static typename C::container6& column (C& x) {return x._c6.d;}
+    template <typename C> static const typename C::container6& column (const C& x) {return x._c6.d;}};
+
+template <>
+struct field_access<7> {
+    template <typename R> struct type {typedef typename R::type7 value;};
+    template <typename C> struct container {typedef typename C::container7 type;};
+    template <typename C> static typename C::container7& column (C& x) {return x._c7.d;}
+    template <typename C> static const typename C::container7& column (const C& x) {return x._c7.d;}};
+
+// -------------
+// ColumnarDeque
+// -------------
+
+/**
+ * A deque of records stored struct-of-arrays: one MyDeque per field, all
+ * pushed and popped in lockstep so they keep the same _ob/_oe geometry.
+ * Rows are read and written through a reference proxy; column<I>() gives
+ * a field's MyDeque for scans, whose segment() runs are contiguous arrays
+ * of that field alone. A bool field is kept in a packed MyDeque<bool>, whose
+ * rows hold words rather than fields, and is read and written by value or
+ * through its proxy reference.
+ */
+template < typename F0, typename F1 = NullColumn, typename F2 = NullColumn, typename F3 = NullColumn,
+           typename F4 = NullColumn, typename F5 = NullColumn, typename F6 = NullColumn, typename F7 = NullColumn >
+class ColumnarDeque {
+    template <int> friend struct field_access;
+
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef Row<F0, F1, F2, F3, F4, F5, F6, F7> value_type;
+        typedef typename MyDeque<F0>::size_type size_type;
+
+        typedef MyDeque<F0> container0;
+        typedef MyDeque<F1> container1;
+        typedef MyDeque<F2> container2;
+        typedef MyDeque<F3> container3;
+        typedef MyDeque<F4> container4;
+        typedef MyDeque<F5> container5;
+        typedef MyDeque<F6> container6;
+        typedef MyDeque<F7> container7;
+
+    public:
+        // ---------
+        // reference
+        // ---------
+
+        /**
+	 * stands for one row: converts to a value_type, is assigned from one,
+	 * and reaches a single field in place with get<I>()
+	 */
+        class reference {
+            private:
+                ColumnarDeque* x;
+                size_type i;
+
+            public:
+                reference (ColumnarDeque* p, size_type index) : x(p), i(index) {}
+
+                // Default copy and destructor.
+                // reference (const reference&);
+                // ~reference ();
+
+                /**
+		 * @return a reference to field I of this row, the column's own
+		 * reference type, so a proxy for a bool field
+		 */
+                template <int I>
+                typename field_access<I>::template container<ColumnarDeque>::type::reference get () const {
+                    return field_access<I>::column(*x)[i];}
+
+                /**
+		 * @return a copy of this row
+		 */
+                operator value_type () const {
+                    return x->get(i);}
+
+                /**
+		 * @param r the values to store in this row
+		 */
+                reference& operator = (const value_type& r) {
+                    x->set(i, r);
+                    return *this;}
+
+                reference& operator = (const reference& that) {
+                    x->set(i, value_type(that));
+                    return *this;}};
+
+    private:
+        // ----
+        // data
+        // ----
+
+        ColumnStore<F0> _c0;
+        ColumnStore<F1> _c1;
+        ColumnStore<F2> _c2;
+        ColumnStore<F3> _c3;
+        ColumnStore<F4> _c4;
+        ColumnStore<F5> _c5;
+        ColumnStore<F6> _c6;
+        ColumnStore<F7> _c7;
+
+    private:
+        // -----
+        // valid
+        // -----
+
+        bool valid () const {
+            const size_type n = size();
+            return _c1.matches(n) && _c2.matches(n) && _c3.matches(n) && _c4.matches(n) &&
+                   _c5.matches(n) && _c6.matches(n) && _c7.matches(n);}
+
+        value_type get (size_type i) const {
+            return value_type(_c0.get(i), _c1.get(i), _c2.get(i), _c3.get(i), _c4.get(i), _c5.get(i), _c6.get(i), _c7.get(i));}
+
+        void set (size_type i, const value_type& r) {
+            _c0.set(i, r.f0);
+            _c1.set(i, r.f1);
+            _c2.set(i, r.f2);
+            _c3.set(i, r.f3);
+            _c4.set(i, r.f4);
+            _c5.set(i, r.f5);
+            _c6.set(i, r.f6);
+            _c7.set(i, r.f7);}
+
+        /**
+	 * pops the first k columns at the back, undoing a push_back that threw
+	 */
+        void unwind_back (int k) {
+            if (k > 0) _c0.pop_back();
+            if (k > 1) _c1.pop_back();
+            if (k > 2) _c2.pop_back();
+            if (k > 3) _c3.pop_back();
+            if (k > 4) _c4.pop_back();
+            if (k > 5) _c5.pop_back();
+            if (k > 6) _c6.pop_back();}
+
+        void unwind_front (int k) {
+            if (k > 0) _c0.pop_front();
+            if (k > 1) _c1.pop_front();
+            if (k > 2) _c2.pop_front();
+            if (k > 3) _c3.pop_front();
+            if (k > 4) _c4.pop_front();
+            if (k > 5) _c5.pop_front();
+            if (k > 6) _c6.pop_front();}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+	 * Default constructor
+	 */
+        ColumnarDeque () {
+            assert(valid());}
+
+        /**
+	 * @param s the number of rows
+	 * @param v the row to fill them with
+	 */
+        explicit ColumnarDeque (size_type s, const value_type& v = value_type()) :
+                _c0(s, v.f0), _c1(s, v.f1), _c2(s, v.f2), _c3(s, v.f3), _c4(s, v.f4), _c5(s, v.f5), _c6(s, v.f6), _c7(s, v.f7) {
+            assert(valid());}
+
+        // Default copy, destructor, and copy assignment.
+        // ColumnarDeque (const ColumnarDeque&);
+        // ~ColumnarDeque ();
+        // ColumnarDeque& operator = (const ColumnarDeque&);
+
+        // -----------
+        // operator []
+        // -----------
+
+        /**
+	 * @param i the index of the row
+	 * @return a proxy for the ith row
+	 */
+        reference operator [] (size_type i) {
+            return reference(this, i);}
+
+        /**
+	 * @param i the index of the row
+	 * @return a copy of the ith row
+	 */
+        value_type operator [] (size_type i) const {
+            return get(i);}
+
+        // -----------
+        // front, back
+        // -----------
+
+        /**
+	 * @return a proxy for the first row
+	 */
+        reference front () {
+            assert(!empty());
+            return (*this)[0];}
+
+        /**
+	 * @return a proxy for the last row
+	 */
+        reference back () {
+            assert(!empty());
+            return (*this)[size() - 1];}
+
+        // -----
+        // clear
+        // -----
+
+        /**
+	 * Removes every row
+	 */
+        void clear () {
+            _c0.clear();
+            _c1.clear();
+            _c2.clear();
+            _c3.clear();
+            _c4.clear();
+            _c5.clear();
+            _c6.clear();
+            _c7.clear();
+            assert(valid());}
+
+        // ------
+        // column
+        // ------
+
+        /**
+	 * @return the MyDeque holding field I of every row
+	 */
+        template <int I>
+        const MyDeque<typename field_access<I>::template type<value_type>::value>& column () const {
+            return field_access<I>::column(*this);}
+
+        // -----
+        // empty
+        // -----
+
+        /**
+	 * @return True if there are no rows
+	 */
+        bool empty () const {
+            return !size();}
+
+        // ---
+        // pop
+        // ---
+
+        /**
+	 * removes the last row
+	 */
+        void pop_back () {
+            assert(!empty());
+            _c0.pop_back();
+            _c1.pop_back();
+            _c2.pop_back();
+            _c3.pop_back();
+            _c4.pop_back();
+            _c5.pop_back();
+            _c6.pop_back();
+            _c7.pop_back();
+            assert(valid());}
+
+        /**
+	 * removes the first row
+	 */
+        void pop_front () {
+            assert(!empty());
+            _c0.pop_front();
+            _c1.pop_front();
+            _c2.pop_front();
+            _c3.pop_front();
+            _c4.pop_front();
+            _c5.pop_front();
+            _c6.pop_front();
+            _c7.pop_front();
+            assert(valid());}
+
+        // ----
+        // push
+        // ----
+
+        /**
+	 * adds r after the last row; if a field cannot be added, the fields
+	 * that were are removed again
+	 * @param r the row to add
+	 */
+        void push_back (const value_type& r) {
+            int k = 0;
+            try {
+                _c0.push_back(r.f0); ++k;
+                _c1.push_back(r.f1); ++k;
+                _c2.push_back(r.f2); ++k;
+                _c3.push_back(r.f3); ++k;
+                _c4.push_back(r.f4); ++k;
+                _c5.push_back(r.f5); ++k;
+                _c6.push_back(r.f6); ++k;
+                _c7.push_back(r.f7);}
+            catch (...) {
+                unwind_back(k);
+                throw;}
+            assert(valid());}
+
+        /**
+	 * adds r before the first row; if a field cannot be added, the fields
+	 * that were are removed again
+	 * @param r the row to add
+	 */
+        void push_front (const value_type& r) {
+            int k = 0;
+            try {
+                _c0.push_front(r.f0); ++k;
+                _c1.push_front(r.f1); ++k;
+                _c2.push_front(r.f2); ++k;
+                _c3.push_front(r.f3); ++k;
+                _c4.push_front(r.f4); ++k;
+                _c5.push_front(r.f5); ++k;
+                _c6.push_front(r.f6); ++k;
+                _c7.push_front(r.f7);}
+            catch (...) {
+                unwind_front(k);
+                throw;}
+            assert(valid());}
+
+        // ----
+        // size
+        // ----
+
+        /**
+	 * @return the number of rows
+	 */
+        size_type size () const {
+            return _c0.d.size();}};
+
+#endif // ColumnarDeque_h
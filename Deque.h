@@ -11,13 +11,17 @@
 // includes
 // --------
 
-#include <algorithm> // copy, equal, lexicographical_compare, max, swap
+#include <algorithm> // copy, equal, lexicographical_compare, max, reverse_copy, swap, swap_ranges
 #include <cassert> // assert
+#include <climits> // CHAR_BIT
 #include <iterator> // iterator, bidirectional_iterator_tag
 #include <memory> // allocator
 #include <stdexcept> // out_of_range
 #include <utility> // !=, <=, >, >=
 #include <iostream>
+
+#include "DequeKernels.h"
+
 // -----
 // using
 // -----
@@ -71,6 +75,39 @@ BI uninitialized_fill (A& a, BI b, BI e, const U& v) {
         throw;}
     return e;}
 
+// -------------
+// MyDequeHandle
+// -------------
+
+/**
+ * Names an element of a MyDeque by its place in the order of pushes, seq,
+ * within a generation of the MyDeque, gen. A MyDeque starts in generation
+ * 0 and draws a fresh one whenever all its elements are removed at once,
+ * so a handle from an earlier generation is never contained again.
+ */
+template <typename S>
+struct MyDequeHandle {
+    S seq;
+    S gen;
+
+    MyDequeHandle (S s, S g) : seq(s), gen(g) {}
+
+    friend bool operator == (const MyDequeHandle& lhs, const MyDequeHandle& rhs) {
+        return (lhs.seq == rhs.seq) && (lhs.gen == rhs.gen);}
+
+    /**
+     * @return a generation that no MyDeque has had yet; it would take 2^64
+     * draws to wrap a 64-bit S
+     */
+    static S next_generation () {
+        static S g = 0;
+#ifdef __GNUC__
+        return __sync_add_and_fetch(&g, 1);
+#else
+        return ++g;
+#endif
+        }};
+
 // -----
 // MyDeque
 // -----
@@ -97,6 +134,9 @@ class MyDeque {
 	typedef typename allocator_type::template rebind<T*>::other outer_allocator;
 	typedef typename allocator_type::template rebind<T*>::other::pointer outer_pointer;
 
+        // names an element by its place in the order of pushes, not by its index
+        typedef MyDequeHandle<size_type> handle_type;
+
     public:
         // -----------
         // operator ==
@@ -108,7 +148,7 @@ class MyDeque {
          * @return True if MyDeques are the same size and have the same contents
 	 */
         friend bool operator == (const MyDeque& lhs, const MyDeque& rhs) {
-            return (lhs.size() == 0 && rhs.size() == 0) || ((lhs.size() == rhs.size()) && std::equal(lhs.begin(), lhs.end(), rhs.begin()));}
+            return (lhs.size() == rhs.size()) && (lhs.mismatch(rhs, 0, lhs.size()) == lhs.size());}
 
         // ----------
         // operator <
@@ -120,7 +160,15 @@ class MyDeque {
          * @return True if lhs comes before rhs in the lexicographical compare
 	 */
         friend bool operator < (const MyDeque& lhs, const MyDeque& rhs) {
-            return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());}
+            const size_type n = std::min(lhs.size(), rhs.size());
+            for (size_type i = 0; ; ++i) {
+                i = lhs.mismatch(rhs, i, n);
+                if (i == n)
+                    return lhs.size() < rhs.size();
+                if (lhs[i] < rhs[i])
+                    return true;
+                if (rhs[i] < lhs[i])
+                    return false;}}
 
     private:
         // ----
@@ -141,9 +189,74 @@ class MyDeque {
 	outer_pointer _ol;
 
 	size_type _arraySize;
-	
+
+        // the handle of the front element; element i has handle _front_seq + i
+        size_type _front_seq;
+
+        // the generation of the handles, see MyDequeHandle
+        size_type _gen;
+
+        // row size of a MyDeque that was not given a size
+        enum {defaultArraySize = 512};
+
+        // elements per 64-byte cache line, at least one
+        enum {lineElements = (sizeof(T) < 64) ? 64 / sizeof(T) : 1};
 
     private:
+        // ----------------------------
+        // propagate_on_copy_assignment
+        // ----------------------------
+
+        /**
+	 * value is A::propagate_on_container_copy_assignment::value, or false
+	 * when A does not declare it, as no C++98 allocator does.
+	 */
+        class propagate_on_copy_assignment {
+            private:
+                template <typename U>
+                static char (&test (typename U::propagate_on_container_copy_assignment*))[2];
+
+                template <typename U>
+                static char test (...);
+
+                template <bool D, typename U>
+                struct declared {
+                    enum {value = false};};
+
+                template <typename U>
+                struct declared<true, U> {
+                    enum {value = U::propagate_on_container_copy_assignment::value};};
+
+            public:
+                enum {value = declared<sizeof(test<A>(0)) == 2, A>::value};};
+
+        // -----------------
+        // propagate_on_swap
+        // -----------------
+
+        /**
+	 * value is A::propagate_on_container_swap::value, or false when A does
+	 * not declare it.
+	 */
+        class propagate_on_swap {
+            private:
+                template <typename U>
+                static char (&test (typename U::propagate_on_container_swap*))[2];
+
+                template <typename U>
+                static char test (...);
+
+                template <bool D, typename U>
+                struct declared {
+                    enum {value = false};};
+
+                template <typename U>
+                struct declared<true, U> {
+                    enum {value = U::propagate_on_container_swap::value};};
+
+            public:
+                enum {value = declared<sizeof(test<A>(0)) == 2, A>::value};};
+
         // -----
         // valid
         // -----
@@ -152,29 +265,217 @@ class MyDeque {
             return (!_b && !_e && !_of && !_ob && !_oe && !_ol) || (((_of <= _ob) && (_ob <= _oe) && (_oe <= _ol)) && ((*_ob <= _b) && (*_oe <= _e)));}
 
 
-        MyDeque (const MyDeque& that, int rows) : _a(that._a), _size(that._size), _oa(that._oa), _arraySize(that._arraySize) {
-            _of = _oa.allocate(rows);
-            _ob = _of + (that._ob - that._of);
-            _oe = _of + (that._oe - that._of);
-            _ol = _of + rows;
-/*
-            uninitialized_copy(_oa, that._ob, (that._oe) + 1, _ob);
-	    _b = that._b;
-            _e = that._e;
-	    //_b = *_ob + (that._b - *(that._ob));
-       	    //_e = *_oe + (that._e - *(that._oe));
-            assert(valid());}*/
+        // ------------
+        // allocate_map
+        // ------------
 
+        /**
+	 * Gives a MyDeque without storage an outer array of three rows and one
+	 * row of _arraySize, or of defaultArraySize if that is zero, with the
+	 * elements starting a third of the way into the row.
+	 */
+        void allocate_map () {
+            if (!_arraySize)
+                _arraySize = defaultArraySize;
+            _of = _oa.allocate(3);
+            _ob = _of + 1;
+            _oe = _ob;
+            _ol = _of + 3;
+            *_ob = _a.allocate(_arraySize);
+            _b = _e = *_ob + _arraySize / 3;}
 
-	    for(int i = 0; i <= (_oe - _ob); ++i) {
-	            *(_ob+i) = _a.allocate(_arraySize);	
-	    }
-	    _b = *_ob + (that._b - *(that._ob));
-       	    _e = *_oe + (that._e - *(that._oe));
+        // --------
+        // grow_map
+        // --------
 
-            uninitialized_copy(_a, that.begin(), that.end(), begin());
+        /**
+	 * Reallocates the outer array so that there are at least front free rows
+	 * before _ob and back free rows after _oe. Only row pointers are copied.
+	 */
+        void grow_map (size_type front, size_type back) {
+            const size_type used = _oe - _ob + 1;
+            if (size_type(_ob - _of) >= front && size_type(_ol - _oe - 1) >= back)
+                return;
+            const size_type rows = std::max(size_type(2 * (_ol - _of)), used + front + back);
+            outer_pointer of = _oa.allocate(rows);
+            outer_pointer ob = of + front + (rows - used - front - back) / 2;
+            std::copy(_ob, _oe + 1, ob);
+            _oa.deallocate(_of, _ol - _of);
+            _of = of;
+            _ob = ob;
+            _oe = ob + used - 1;
+            _ol = of + rows;}
+
+        // -----
+        // reset
+        // -----
+
+        /**
+	 * Frees the outer array once its rows have been handed to another MyDeque
+	 * or deallocated, leaving this MyDeque empty and without storage.
+	 */
+        void reset () {
+            if (_of)
+                _oa.deallocate(_of, _ol - _of);
+            _b = _e = 0;
+            _of = _ob = _oe = _ol = 0;
+            _size = 0;}
+
+        // --------------
+        // retire_handles
+        // --------------
+
+        /**
+	 * Moves to a fresh generation, before every element is removed, so that
+	 * no handle handed out so far is contained again.
+	 */
+        void retire_handles () {
+            _gen = handle_type::next_generation();}
+
+        // ------------
+        // reserve_back
+        // ------------
+
+        /**
+	 * Allocates rows past _oe, and the outer array if there is none, so that
+	 * s elements fit. The new slots are left unconstructed.
+	 */
+        void reserve_back (size_type s) {
+            if (!_b)
+                allocate_map();
+            const size_type moreRows = (s + offset()) / _arraySize - (_oe - _ob);
+            grow_map(0, moreRows);
+            for (size_type i = 0; i != moreRows; ++i) {
+                *(_oe + 1) = _a.allocate(_arraySize);
+                ++_oe;}}
+
+        // ------------
+        // release_back
+        // ------------
+
+        /**
+	 * Frees the rows past the one that holds the end of the first n elements.
+	 */
+        void release_back (size_type n) {
+            const outer_pointer oe = _ob + (offset() + n) / _arraySize;
+            while (_oe != oe) {
+                _a.deallocate(*_oe, _arraySize);
+                --_oe;}}
+
+        // ------
+        // append
+        // ------
+
+        /**
+	 * Copy constructs that[i, that.size()) past the last element, a row of
+	 * each at a time. If a copy throws, this MyDeque is left as it was.
+	 */
+        void append (const MyDeque& that, size_type i) {
+            if (i == that._size)
+                return;
+            const size_type n = _size;
+            const size_type s = n + (that._size - i);
+            reserve_back(s);
+            _size = s;
+            size_type j = n;
+            try {
+                while (j != s) {
+                    size_type m;
+                    size_type k;
+                    const pointer p = segment(j, m);
+                    const const_pointer q = that.segment(i, k);
+                    m = std::min(m, k);
+                    uninitialized_copy(_a, q, q + m, p);
+                    i += m;
+                    j += m;}}
+            catch (...) {
+                _size = j;
+                pop_back_n(j - n);
+                release_back(n);
+                throw;}
+            _e = *_oe + (offset() + s) % _arraySize;
             assert(valid());}
 
+        // ------------
+        // swap_storage
+        // ------------
+
+        /**
+	 * Trades rows and outer arrays with that; the allocators stay put.
+	 */
+        void swap_storage (MyDeque& that) {
+            std::swap(_b, that._b);
+            std::swap(_e, that._e);
+            std::swap(_of, that._of);
+            std::swap(_ob, that._ob);
+            std::swap(_oe, that._oe);
+            std::swap(_ol, that._ol);
+            std::swap(_arraySize, that._arraySize);
+            std::swap(_size, that._size);
+            std::swap(_front_seq, that._front_seq);
+            std::swap(_gen, that._gen);}
+
+        // ------
+        // offset
+        // ------
+
+        /**
+	 * @return the column of the first element within the first row
+	 */
+        size_type offset () const {
+            return _b - *_ob;}
+
+        // --------
+        // prefetch
+        // --------
+
+        /**
+	 * Hints that the element at column col of row r is about to be read.
+	 * Within a row the hardware prefetcher keeps up with a scan; the jump to
+	 * the next row is what it misses, so scans ask for the next row one row
+	 * ahead. Build with -DDEQUE_NO_PREFETCH to compare.
+	 */
+        void prefetch (outer_pointer r, size_type col) const {
+#if defined(__GNUC__) && !defined(DEQUE_NO_PREFETCH)
+            if (r <= _oe)
+                __builtin_prefetch(*r + col);
+#else
+            (void) r;
+            (void) col;
+#endif
+            }
+
+        /**
+	 * called as an iterator moves to index; once per cache line, prefetches
+	 * the line in the same column of the next row
+	 */
+        void step (size_type index) const {
+            if ((index % lineElements) || (index >= _size))
+                return;
+            const size_type p = offset() + index;
+            prefetch(_ob + p / _arraySize + 1, p % _arraySize);}
+
+        // --------
+        // mismatch
+        // --------
+
+        /**
+	 * compares the two MyDeques a run of contiguous elements at a time
+	 * @return the first index in [i, n) at which this MyDeque and that differ, or n
+	 */
+        size_type mismatch (const MyDeque& that, size_type i, size_type n) const {
+            while (i != n) {
+                size_type m;
+                size_type k;
+                const_pointer p = segment(i, m);
+                const_pointer q = that.segment(i, k);
+                k = std::min(std::min(m, k), n - i);
+                m = mismatch_kernel(p, q, k);
+                i += m;
+                if (m != k)
+                    break;}
+            return i;}
+
     public:
         // --------
         // iterator
@@ -294,6 +595,7 @@ class MyDeque {
 		 */
                 iterator& operator ++ () {
 			++index;
+                    x->step(index);
                     assert(valid());
                     return *this;}
 
@@ -472,6 +774,7 @@ class MyDeque {
 		 */
                 const_iterator& operator ++ () {
                     ++index;
+                    x->step(index);
                     assert(valid());
                     return *this;}
 
@@ -540,7 +843,7 @@ class MyDeque {
 	 * @param allocator_type a The allocator to use
          * Default constructor
 	 */
-        explicit MyDeque (const allocator_type& a = allocator_type()) : _a(a),  _b(0), _e(0),  _size(0), _oa(a), _of(0), _ob(0), _oe(0), _ol(0), _arraySize(0) {
+        explicit MyDeque (const allocator_type& a = allocator_type()) : _a(a),  _b(0), _e(0),  _size(0), _oa(a), _of(0), _ob(0), _oe(0), _ol(0), _arraySize(0), _front_seq(0), _gen(0) {
             assert(valid());}
 
         /**
@@ -548,18 +851,17 @@ class MyDeque {
          * @param const_reference v a value to fill the deque with
          * @param allocator_type a The allocator to use
 	 */
-        explicit MyDeque (size_type s, const_reference v = value_type(), const allocator_type& a = allocator_type()) : _a(a), _size(s), _oa(a) {
+        explicit MyDeque (size_type s, const_reference v = value_type(), const allocator_type& a = allocator_type()) : _a(a), _size(s), _oa(a), _front_seq(0), _gen(0) {
             _of = _oa.allocate(3);
 	    _ob = _of + 1;
 	    _oe = _ob;
 	    _ol = _of + 3;
 
-	    *_ob = _a.allocate(3 * s);
-            _b = *_ob + s;
-            _e = *_ob + 2*s;
-	   
-            _arraySize = 3*s;
-            
+            _arraySize = s ? 3 * s : size_type(defaultArraySize);
+	    *_ob = _a.allocate(_arraySize);
+            _b = *_ob + _arraySize / 3;
+            _e = _b + s;
+
 	    uninitialized_fill(_a, begin(), end(), v);
 
 	    
@@ -569,7 +871,10 @@ class MyDeque {
 	* @param MyDeque that
         * Copy constructor - copy all data from that into a new MyDeque
 	*/
-        MyDeque (const MyDeque& that) : _a(that._a), _size(that._size), _oa(that._oa), _arraySize(that._arraySize) {
+        MyDeque (const MyDeque& that) : _a(that._a), _b(0), _e(0), _size(0), _oa(that._oa), _of(0), _ob(0), _oe(0), _ol(0), _arraySize(that._arraySize), _front_seq(that._front_seq), _gen(that._gen) {
+            if (!that._b)
+                return;
+            _size = that._size;
             _of = _oa.allocate(that._ol - that._of);
             _ob = _of + (that._ob - that._of);
             _oe = _of + (that._oe - that._of);
@@ -610,23 +915,40 @@ class MyDeque {
         // ----------
 
         /**
+	* Copy assigns over the elements both MyDeques have, then destroys the
+	* surplus or copy constructs the rest, so existing rows are reused and
+	* no element is default constructed. If A propagates on copy assignment
+	* and the allocators differ, the storage is rebuilt from that's allocator.
 	* @return A reference to MyDeque for assignment
 	* @param that a MyDeque to be assigned
 	*/
         MyDeque& operator = (const MyDeque& that) {
 	    if (this == &that)
                 return *this;
-            if (that.size() == size())
-                std::copy(that.begin(), that.end(), begin());
-            else if (that.size() < size()) {
-                std::copy(that.begin(), that.end(), begin());
-                resize(that.size());}
-            else {
-                clear();
-		resize(that.size());
-                iterator eIter = std::copy(that.begin(), that.end(), begin());
-		_e = &(*eIter);
-	    }
+            if (propagate_on_copy_assignment::value) {
+                if (!(_a == that._a)) {
+                    // x frees this storage through the allocator it came from
+                    MyDeque x(that);
+                    swap_storage(x);
+                    std::swap(_a, x._a);
+                    std::swap(_oa, x._oa);
+                    return *this;}
+                _a = that._a;
+                _oa = that._oa;}
+            const size_type n = std::min(_size, that._size);
+            size_type m;
+            for (size_type i = 0; i != n; i += m) {
+                size_type k;
+                const pointer p = segment(i, m);
+                const const_pointer q = that.segment(i, k);
+                m = std::min(std::min(m, k), n - i);
+                std::copy(q, q + m, p);}
+            if (n != _size)
+                pop_back_n(_size - n);
+            else
+                append(that, n);
+            _front_seq = that._front_seq;
+            _gen = that._gen;
             assert(valid());
             return *this;}
 
@@ -713,14 +1035,58 @@ class MyDeque {
         // -----
 
         /**
-	* Removes all elements by resizing the deque to 0
+	* Removes all elements by resizing the deque to 0; their handles are
+	* never contained again
 	*/
         void clear () {
+            retire_handles();
             resize(0);
 	    assert(_b == _e); 
 	    assert(_ob == _oe);
             assert(valid());}
 
+        // -----
+        // drain
+        // -----
+
+        /**
+	 * moves up to n elements off the back, last first, copying and then
+	 * destroying them a row at a time
+	 * @param n the most elements to take
+	 * @param out where the elements are copied to
+	 * @return out past the copied elements
+	 */
+        template <typename OI>
+        OI drain_back (size_type n, OI out) {
+            n = std::min(n, _size);
+            while (n) {
+                const size_type c = (offset() + _size - 1) % _arraySize;
+                const size_type m = std::min(c + 1, n);
+                const_pointer p = &(*this)[_size - 1] + 1;
+                out = std::reverse_copy(p - m, p, out);
+                pop_back_n(m);
+                n -= m;}
+            return out;}
+
+        /**
+	 * moves up to n elements off the front, first first, copying and then
+	 * destroying them a row at a time
+	 * @param n the most elements to take
+	 * @param out where the elements are copied to
+	 * @return out past the copied elements
+	 */
+        template <typename OI>
+        OI drain_front (size_type n, OI out) {
+            n = std::min(n, _size);
+            while (n) {
+                size_type m;
+                const_pointer p = segment(0, m);
+                m = std::min(m, n);
+                out = std::copy(p, p + m, out);
+                pop_front_n(m);
+                n -= m;}
+            return out;}
+
         // -----
         // empty
         // -----
@@ -780,6 +1146,58 @@ class MyDeque {
         const_reference front () const {
             return const_cast<MyDeque*>(this)->front();}
 
+        // -------------
+        // get_allocator
+        // -------------
+
+        /**
+	 * @return a copy of the allocator the elements come from
+	 */
+        allocator_type get_allocator () const {
+            return _a;}
+
+        // -------
+        // handles
+        // -------
+
+        /**
+	 * Unlike an index or an iterator, a handle keeps naming the same element
+	 * across push_front, pop_front, push_back and pop_back, and across
+	 * split_at and splice_front. Once the element is removed by clear, or
+	 * spliced out of that, the handle is never contained again. Once it is
+	 * popped the handle is no longer contained either, but a later push at
+	 * the same end takes the same place in the order and reuses it, so a
+	 * handle to a popped element may name the element pushed after it.
+	 * insert and erase away from the ends move elements between handles.
+	 * @param index the index of an element
+	 * @return a handle to that element
+	 */
+        handle_type handle (size_type index) const {
+            assert(index < _size);
+            return handle_type(_front_seq + index, _gen);}
+
+        /**
+	 * @return true if h names an element of this MyDeque
+	 */
+        bool contains (handle_type h) const {
+            return (h.gen == _gen) && (size_type(h.seq - _front_seq) < _size);}
+
+        /**
+	 * @return the current index of the element h names, which must be contained
+	 */
+        size_type position (handle_type h) const {
+            assert(contains(h));
+            return h.seq - _front_seq;}
+
+        /**
+	 * @return the element h names, which must be contained
+	 */
+        reference get (handle_type h) {
+            return (*this)[position(h)];}
+
+        const_reference get (handle_type h) const {
+            return (*this)[position(h)];}
+
         // ------
         // insert
         // ------
@@ -818,7 +1236,26 @@ class MyDeque {
 	 */
         void pop_back () {
             assert(!empty());
-            resize(_size - 1);
+            pop_back_n(1);}
+
+        /**
+	 * removes the last n elements, destroying them a row at a time and
+	 * freeing the rows they leave empty
+	 * @param n at most size()
+	 */
+        void pop_back_n (size_type n) {
+            assert(n <= _size);
+            if (!n)
+                return;
+            const size_type s = _size - n;
+            size_type m;
+            for (size_type i = s; i != _size; i += m) {
+                const pointer p = segment(i, m);
+                for (size_type j = 0; j != m; ++j)
+                    _a.destroy(p + j);}
+            release_back(s);
+            _e = *_oe + (offset() + s) % _arraySize;
+            _size = s;
             assert(valid());}
 
         /**
@@ -827,8 +1264,35 @@ class MyDeque {
         void pop_front () {
             assert(!empty());
             _a.destroy(_b);
-	    _b = &at(1);
+            if (++_b == *_ob + _arraySize) {
+                _a.deallocate(*_ob, _arraySize);
+                ++_ob;
+                _b = *_ob;}
 	    --_size;
+            ++_front_seq;
+            assert(valid());}
+
+        /**
+	 * removes the first n elements, destroying them a row at a time and
+	 * freeing each row as it empties
+	 * @param n at most size()
+	 */
+        void pop_front_n (size_type n) {
+            assert(n <= _size);
+            _front_seq += n;
+            while (n) {
+                size_type m;
+                const pointer p = segment(0, m);
+                m = std::min(m, n);
+                for (size_type j = 0; j != m; ++j)
+                    _a.destroy(p + j);
+                _b += m;
+                _size -= m;
+                n -= m;
+                if (_b == *_ob + _arraySize) {
+                    _a.deallocate(*_ob, _arraySize);
+                    ++_ob;
+                    _b = *_ob;}}
             assert(valid());}
 
         // ----
@@ -850,33 +1314,25 @@ class MyDeque {
          * Push to front of deque
 	 */
         void push_front (const_reference v) {
-		using namespace std;
-	    if (*_ob != _b) {
-		//space available on this row
-		--_b;
-		*begin() = v;
-		++_size;
-	    }
-	    else if (_ob != _of) {
-		//space available for a new row
-		--_ob;
-		*_ob = _a.allocate(_arraySize);
-		_b = *_ob + _arraySize - 1;
-		*begin() = v;
-		++_size;
-	    }
-	    else {
-		//need to resize outer array
-		MyDeque x(*this, _ol - _of + 2);
-		swap(x);
-		std::copy_backward(_ob, _ol - 2, _ol);
-		_oe += 2;
-		++_ob;
-		*_ob = _a.allocate(_arraySize);
-		_b = *_ob + _arraySize - 1;
-		*begin() = v;
-		++_size;
-	    }
+            if (!_b)
+                allocate_map();
+            if (*_ob != _b) {
+                //space available on this row
+                _a.construct(_b - 1, v);
+                --_b;}
+            else {
+                //start a new row, growing the outer array if there is no room for it
+                grow_map(1, 0);
+                const pointer p = _a.allocate(_arraySize);
+                try {
+                    _a.construct(p + _arraySize - 1, v);}
+                catch (...) {
+                    _a.deallocate(p, _arraySize);
+                    throw;}
+                *--_ob = p;
+                _b = p + _arraySize - 1;}
+            ++_size;
+            --_front_seq;
             assert(valid());}
 
         // ------
@@ -888,43 +1344,24 @@ class MyDeque {
         * @param const_reference v Value to fill new positions with if size is greater than current size
 	*/
         void resize (size_type s, const_reference v = value_type()) {
-            iterator eIter(this, _size);
-
             if( s == size())
 		return;
 	    else if (s < size()) {
-                eIter = destroy(_a, begin() + difference_type(s), end());
-		_e = &*eIter;
-		_oe = _ob + ((s + (_b - *_ob)) / _arraySize);
+                pop_back_n(size() - s);
+                return;
 	    } else {
-
-                // get hypothetical row number of bigger size's back element
-                int endRowNum = (s + (_b - *_ob)) / _arraySize;
-
-                if(endRowNum == (_oe - _ob)) {
-			_size = s;
-			eIter = uninitialized_fill(_a, end(), begin() + difference_type(s), v);
-			_e = &*eIter;
-                        // _oe stays the same
-		} else if (endRowNum < (_ol - _ob)) {
-			_size = s;			
-			int moreRows = endRowNum - (_oe - _ob);
-			for (int i = 0; i < moreRows; ++i) {
-				++_oe;
-				*_oe = _a.allocate(_arraySize);
-				
-			}
-			eIter = uninitialized_fill(_a, end(), begin() + difference_type(s), v);
-			_e = &*eIter;
-		} else {
-			int moreRows = endRowNum - (_ol - _ob) + 1;
-			int totalRows = _ol-_of + moreRows;
-			MyDeque x(*this, totalRows);
-			swap(x);
-			resize(s, v);
-		}
+                reserve_back(s);
+                const size_type n = _size;
+                _size = s;
+                try {
+                    uninitialized_fill(_a, begin() + difference_type(n), end(), v);}
+                catch (...) {
+                    _size = n;
+                    release_back(n);
+                    throw;}
+                _e = *_oe + (offset() + s) % _arraySize;
             }
-	    
+
             _size = s;
             assert(valid());}
 
@@ -939,28 +1376,1226 @@ class MyDeque {
             return _size;
 	}
 
+        // -------
+        // segment
+        // -------
+
+        /**
+	 * @param index the index of an element
+	 * @param n set to the number of elements from index to the end of its row or of the MyDeque, whichever comes first
+	 * @return a pointer to the element at index, followed contiguously by the other n - 1
+	 */
+        pointer segment (size_type index, size_type& n) {
+            assert(index < _size);
+            const size_type p = offset() + index;
+            const size_type col = p % _arraySize;
+            n = std::min(_arraySize - col, _size - index);
+            const outer_pointer r = _ob + p / _arraySize;
+            for (size_type i = 0; (i < 4 * lineElements) && (i < _arraySize); i += lineElements)
+                prefetch(r + 1, i);
+            return *r + col;}
+
+        /**
+	 * @param index the index of an element
+	 * @param n set to the number of elements from index to the end of its row or of the MyDeque, whichever comes first
+	 * @return a read-only pointer to the element at index, followed contiguously by the other n - 1
+	 */
+        const_pointer segment (size_type index, size_type& n) const {
+            return const_cast<MyDeque*>(this)->segment(index, n);}
+
+        // ------
+        // splice
+        // ------
+
+        /**
+	 * appends that's elements to this MyDeque, leaving that empty
+	 * when both MyDeques have the same row size and allocator and that's
+	 * first element sits in the column right after this MyDeque's last
+	 * element, whole rows are handed over and at most one row of elements is
+	 * copied, none when the two meet on a row edge; otherwise the shorter of the two MyDeques is copied into the
+	 * longer and the storage traded, O(min(size(), that.size())) when the
+	 * allocators are equal and O(that.size()) when they are not
+	 * @param that the MyDeque whose elements are moved
+	 */
+        void splice_back (MyDeque& that) {
+            if (this == &that || that.empty())
+                return;
+            if (empty()) {
+                swap(that);
+                that.clear();
+                return;}
+            const size_type col = (offset() + _size) % _arraySize;
+            if (_arraySize != that._arraySize || col != that.offset() || !(_a == that._a)) {
+                if ((_size < that._size) && (_a == that._a)) {
+                    // copy this in front of that, then take that's storage
+                    const size_type f = _front_seq;
+                    const size_type g = _gen;
+                    size_type i = _size;
+                    try {
+                        for (; i != 0; --i)
+                            that.push_front((*this)[i - 1]);}
+                    catch (...) {
+                        that.pop_front_n(_size - i);
+                        throw;}
+                    swap_storage(that);
+                    _front_seq = f;
+                    _gen = g;}
+                else
+                    append(that, 0);
+                that.clear();
+                return;}
+            grow_map(0, that._oe - that._ob);
+            if (col) {
+                const size_type n = std::min(_arraySize - col, that._size);
+                uninitialized_copy(_a, that._b, that._b + n, _e);
+                destroy(_a, that._b, that._b + n);
+                _a.deallocate(*that._ob, _arraySize);
+                _oe = std::copy(that._ob + 1, that._oe + 1, _oe + 1) - 1;}
+            else {
+                // on a row edge that's first row takes the place of the empty row at _oe
+                _a.deallocate(*_oe, _arraySize);
+                _oe = std::copy(that._ob, that._oe + 1, _oe) - 1;}
+            _size += that._size;
+            _e = *_oe + (offset() + _size) % _arraySize;
+            that.retire_handles();
+            that.reset();
+            assert(valid());}
+
+        /**
+	 * prepends that's elements to this MyDeque, leaving that empty
+	 * when both MyDeques have the same row size and allocator and that's
+	 * last element sits in the column right before this MyDeque's first
+	 * element, whole rows are handed over and at most one row of elements is
+	 * copied, none when the two meet on a row edge; otherwise the shorter of the two MyDeques is copied into the
+	 * longer and the storage traded, O(min(size(), that.size())) when the
+	 * allocators are equal and O(that.size()) when they are not
+	 * @param that the MyDeque whose elements are moved
+	 */
+        void splice_front (MyDeque& that) {
+            if (this == &that || that.empty())
+                return;
+            if (empty()) {
+                swap(that);
+                that.clear();
+                return;}
+            const size_type off = that.offset();
+            const size_type col = (off + that._size) % that._arraySize;
+            if (_arraySize != that._arraySize || col != offset() || !(_a == that._a)) {
+                if ((_size < that._size) && (_a == that._a)) {
+                    // copy this onto the back of that, then take that's storage
+                    const size_type f = _front_seq - that._size;
+                    const size_type g = _gen;
+                    that.append(*this, 0);
+                    swap_storage(that);
+                    _front_seq = f;
+                    _gen = g;}
+                else {
+                    size_type i = that._size;
+                    try {
+                        for (; i != 0; --i)
+                            push_front(that[i - 1]);}
+                    catch (...) {
+                        pop_front_n(that._size - i);
+                        throw;}}
+                that.clear();
+                return;}
+            grow_map(that._oe - that._ob, 0);
+            const size_type n = std::min(col, that._size);
+            uninitialized_copy(_a, that._e - n, that._e, _b - n);
+            destroy(_a, that._e - n, that._e);
+            _a.deallocate(*that._oe, _arraySize);
+            _ob = std::copy_backward(that._ob, that._oe, _ob);
+            _b = *_ob + off;
+            _size += that._size;
+            _front_seq -= that._size;
+            that.retire_handles();
+            that.reset();
+            assert(valid());}
+
+        // --------
+        // split_at
+        // --------
+
+        /**
+	 * removes the elements from pos onward and returns them in a new MyDeque
+	 * whole rows are handed over; only the row holding pos is copied, and
+	 * none when pos is on a row edge
+	 * @param pos the index of the first element to move
+	 * @return a MyDeque holding the elements [pos, size())
+	 * @throw out_of_range exception if pos is greater than size()
+	 */
+        MyDeque split_at (size_type pos) {
+            if (pos > _size)
+                throw std::out_of_range("MyDeque::split_at(pos)");
+            MyDeque x(_a);
+            x._front_seq = _front_seq + pos;
+            x._gen = _gen;
+            if (!_b)
+                return x;
+            const size_type p = offset() + pos;
+            const outer_pointer row = _ob + p / _arraySize;
+            const size_type col = p % _arraySize;
+            const size_type rows = _oe - row + 1;
+            // on a row edge x takes row whole and this MyDeque gets a new
+            // empty end row; otherwise x's first row is a copy of row's tail
+            const size_type n = col ? std::min(_arraySize - col, _size - pos) : 0;
+            // the new row is filled before x owns anything, so a throw leaks nothing
+            const pointer fresh = _a.allocate(_arraySize);
+            try {
+                uninitialized_copy(_a, *row + col, *row + col + n, fresh + col);}
+            catch (...) {
+                _a.deallocate(fresh, _arraySize);
+                throw;}
+            try {
+                x._of = x._oa.allocate(rows + 2);}
+            catch (...) {
+                destroy(_a, fresh + col, fresh + col + n);
+                _a.deallocate(fresh, _arraySize);
+                throw;}
+            destroy(_a, *row + col, *row + col + n);
+            x._arraySize = _arraySize;
+            x._ob = x._of + 1;
+            x._oe = x._ob + rows - 1;
+            x._ol = x._of + rows + 2;
+            std::copy(row, _oe + 1, x._ob);
+            if (col)
+                *x._ob = fresh;
+            else
+                *row = fresh;
+            x._b = *x._ob + col;
+            x._size = _size - pos;
+            x._e = *x._oe + (col + x._size) % _arraySize;
+            _oe = row;
+            _e = *row + col;
+            _size = pos;
+            assert(valid());
+            assert(x.valid());
+            return x;}
+
         // ----
         // swap
         // ----
 
         /**
 	* swaps contents of two MyDeque containers
+	* storage is traded when the allocators are equal or A propagates on
+	* swap; otherwise each MyDeque keeps its allocator, the elements they
+	* both have are swapped in place and the longer one's tail is copied
+	* across, so only the shorter one allocates, and only for that tail
 	*/
         void swap (MyDeque& that) {
-            if (_a == that._a) {
-
-                std::swap(_b, that._b);
-                std::swap(_e, that._e);
-                std::swap(_of, that._of);
-                std::swap(_ob, that._ob);
-                std::swap(_oe, that._oe);
-                std::swap(_ol, that._ol);
-		std::swap(_arraySize, that._arraySize);
-                std::swap(_size, that._size);
-	    } else {
-                MyDeque x(*this);
-                *this = that;
-                that = x;}
+            if (this == &that)
+                return;
+            if (propagate_on_swap::value) {
+                std::swap(_a, that._a);
+                std::swap(_oa, that._oa);
+                swap_storage(that);}
+            else if (_a == that._a)
+                swap_storage(that);
+            else {
+                MyDeque& s = (_size < that._size) ? *this : that;
+                MyDeque& l = (_size < that._size) ? that : *this;
+                const size_type n = s._size;
+                size_type m;
+                for (size_type i = 0; i != n; i += m) {
+                    size_type k;
+                    const pointer p = segment(i, m);
+                    const pointer q = that.segment(i, k);
+                    m = std::min(std::min(m, k), n - i);
+                    std::swap_ranges(p, p + m, q);}
+                s.append(l, n);
+                l.pop_back_n(l._size - n);
+                std::swap(_front_seq, that._front_seq);
+                std::swap(_gen, that._gen);}
             assert(valid());}};
 
+// ----
+// find
+// ----
+
+/**
+ * scans x a row at a time
+ * @return the index of the first element of x equal to v, or x.size()
+ */
+template <typename T, typename A>
+typename MyDeque<T, A>::size_type find_index (const MyDeque<T, A>& x, const T& v) {
+    typename MyDeque<T, A>::size_type i = 0;
+    while (i != x.size()) {
+        typename MyDeque<T, A>::size_type n;
+        const T* p = x.segment(i, n);
+        const typename MyDeque<T, A>::size_type k = find_kernel(p, n, v);
+        i += k;
+        if (k != n)
+            break;}
+    return i;}
+
+/**
+ * @return an iterator to the first element of x equal to v, or x.end()
+ */
+template <typename T, typename A>
+typename MyDeque<T, A>::const_iterator find (const MyDeque<T, A>& x, const T& v) {
+    return x.begin() + find_index(x, v);}
+
+/**
+ * @return an iterator to the first element of x equal to v, or x.end()
+ */
+template <typename T, typename A>
+typename MyDeque<T, A>::iterator find (MyDeque<T, A>& x, const T& v) {
+    return x.begin() + find_index(x, v);}
+
+// -----
+// count
+// -----
+
+/**
+ * @return the number of elements of x equal to v
+ */
+template <typename T, typename A>
+typename MyDeque<T, A>::size_type count (const MyDeque<T, A>& x, const T& v) {
+    typename MyDeque<T, A>::size_type c = 0;
+    typename MyDeque<T, A>::size_type n;
+    for (typename MyDeque<T, A>::size_type i = 0; i != x.size(); i += n) {
+        const T* p = x.segment(i, n);
+        c += count_kernel(p, n, v);}
+    return c;}
+
+// ---------
+// min, max
+// ---------
+
+/**
+ * @return the smallest element of x, which must not be empty
+ */
+template <typename T, typename A>
+T min (const MyDeque<T, A>& x) {
+    assert(!x.empty());
+    T m = x.front();
+    typename MyDeque<T, A>::size_type n;
+    for (typename MyDeque<T, A>::size_type i = 0; i != x.size(); i += n) {
+        const T* p = x.segment(i, n);
+        m = min_kernel(p, n, m);}
+    return m;}
+
+/**
+ * @return the largest element of x, which must not be empty
+ */
+template <typename T, typename A>
+T max (const MyDeque<T, A>& x) {
+    assert(!x.empty());
+    T m = x.front();
+    typename MyDeque<T, A>::size_type n;
+    for (typename MyDeque<T, A>::size_type i = 0; i != x.size(); i += n) {
+        const T* p = x.segment(i, n);
+        m = max_kernel(p, n, m);}
+    return m;}
+
+// ---
+// sum
+// ---
+
+/**
+ * @return T() plus every element of x
+ */
+template <typename T, typename A>
+T sum (const MyDeque<T, A>& x) {
+    T s = T();
+    typename MyDeque<T, A>::size_type n;
+    for (typename MyDeque<T, A>::size_type i = 0; i != x.size(); i += n) {
+        const T* p = x.segment(i, n);
+        s = sum_kernel(p, n, s);}
+    return s;}
+
+// -------------
+// MyDeque<bool>
+// -------------
+
+/**
+ * A MyDeque of flags packed bitsPerWord to a word. The words are held in a
+ * MyDeque of their own, so they grow and shrink at both ends a row at a
+ * time like any other; flag i is bit _off + i of that run of words. Bits
+ * outside [_off, _off + size()) are kept clear, so count() is a popcount
+ * of whole words, and popping from either end only moves _off or the size
+ * instead of shifting bits. Flags are read and written through a proxy
+ * reference, as with std::vector<bool>.
+ */
+template <typename A>
+class MyDeque<bool, A> {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef A allocator_type;
+        typedef bool value_type;
+
+        typedef typename allocator_type::size_type size_type;
+        typedef typename allocator_type::difference_type difference_type;
+
+        class reference;
+        typedef bool const_reference;
+
+        typedef unsigned long word;
+        typedef MyDeque<word, typename allocator_type::template rebind<word>::other> word_container;
+
+        enum {bitsPerWord = CHAR_BIT * sizeof(word)};
+
+        typedef MyDequeHandle<size_type> handle_type;
+
+    public:
+        // -----------
+        // operator ==
+        // -----------
+
+        /**
+	 * @return true if lhs and rhs hold the same flags in the same order
+	 */
+        friend bool operator == (const MyDeque& lhs, const MyDeque& rhs) {
+            if (lhs._size != rhs._size)
+                return false;
+            if (lhs._off == rhs._off)
+                return lhs._w == rhs._w;
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin());}
+
+        // ----------
+        // operator <
+        // ----------
+
+        /**
+	 * @return true if lhs is lexicographically less than rhs
+	 */
+        friend bool operator < (const MyDeque& lhs, const MyDeque& rhs) {
+            return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());}
+
+    private:
+        // ----
+        // data
+        // ----
+
+        word_container _w;
+
+        // the bit of _w.front() that holds the first flag
+        size_type _off;
+        size_type _size;
+
+        // the handle of the front flag; flag i has handle _front_seq + i
+        size_type _front_seq;
+
+        // the generation of the handles, see MyDequeHandle
+        size_type _gen;
+
+    private:
+        // -----
+        // valid
+        // -----
+
+        bool valid () const {
+            return (_off < size_type(bitsPerWord)) &&
+                   (_w.size() == (_off + _size + bitsPerWord - 1) / bitsPerWord);}
+
+        /**
+	 * as in MyDeque<T>, moves to a fresh generation of handles
+	 */
+        void retire_handles () {
+            _gen = handle_type::next_generation();}
+
+        /**
+	 * @return the index of the lowest bit set in w, which must not be 0
+	 */
+        static size_type lowest_bit (word w) {
+            assert(w);
+#ifdef __GNUC__
+            return __builtin_ctzl(w);
+#else
+            size_type i = 0;
+            while (!(w & 1)) {
+                w >>= 1;
+                ++i;}
+            return i;
+#endif
+            }
+
+        /**
+	 * drops the words of an empty MyDeque, so that it starts over at bit 0
+	 */
+        void normalize () {
+            if (!_size) {
+                _w.clear();
+                _off = 0;}}
+
+    public:
+        // ---------
+        // reference
+        // ---------
+
+        /**
+	 * A proxy for one flag that reads and writes its bit.
+	 */
+        class reference {
+            friend class MyDeque;
+
+            private:
+                word* _p;
+                word _m;
+
+                reference (word* p, word m) : _p(p), _m(m) {}
+
+            public:
+                operator bool () const {
+                    return (*_p & _m) != 0;}
+
+                reference& operator = (bool v) {
+                    if (v)
+                        *_p |= _m;
+                    else
+                        *_p &= ~_m;
+                    return *this;}
+
+                reference& operator = (const reference& that) {
+                    return *this = bool(that);}
+
+                void flip () {
+                    *_p ^= _m;}};
+
+    public:
+        // --------
+        // iterator
+        // --------
+
+        class iterator {
+            friend class MyDeque;
+
+            public:
+                // --------
+                // typedefs
+                // --------
+
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef typename MyDeque::value_type value_type;
+                typedef typename MyDeque::difference_type difference_type;
+                typedef void pointer;
+                typedef typename MyDeque::reference reference;
+
+            public:
+                // -----------
+                // operator ==
+                // -----------
+
+                friend bool operator == (const iterator& lhs, const iterator& rhs) {
+                    return (lhs._x == rhs._x) && (lhs._i == rhs._i);}
+
+                friend bool operator != (const iterator& lhs, const iterator& rhs) {
+                    return !(lhs == rhs);}
+
+                // ----------
+                // operator +
+                // ----------
+
+                friend iterator operator + (iterator lhs, difference_type rhs) {
+                    return lhs += rhs;}
+
+                // ----------
+                // operator -
+                // ----------
+
+                friend iterator operator - (iterator lhs, difference_type rhs) {
+                    return lhs -= rhs;}
+
+            private:
+                // ----
+                // data
+                // ----
+
+                MyDeque* _x;
+                size_type _i;
+
+            public:
+                // -----------
+                // constructor
+                // -----------
+
+                iterator (MyDeque* x, size_type i) : _x(x), _i(i) {}
+
+                // Default copy, destructor, and copy assignment.
+                // iterator (const iterator&);
+                // ~iterator ();
+                // iterator& operator = (const iterator&);
+
+                reference operator * () const {
+                    return (*_x)[_i];}
+
+                iterator& operator ++ () {
+                    ++_i;
+                    return *this;}
+
+                iterator operator ++ (int) {
+                    iterator x = *this;
+                    ++(*this);
+                    return x;}
+
+                iterator& operator -- () {
+                    --_i;
+                    return *this;}
+
+                iterator operator -- (int) {
+                    iterator x = *this;
+                    --(*this);
+                    return x;}
+
+                iterator& operator += (difference_type d) {
+                    _i += d;
+                    return *this;}
+
+                iterator& operator -= (difference_type d) {
+                    _i -= d;
+                    return *this;}};
+
+    public:
+        // --------------
+        // const_iterator
+        // --------------
+
+        class const_iterator {
+            public:
+                // --------
+                // typedefs
+                // --------
+
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef typename MyDeque::value_type value_type;
+                typedef typename MyDeque::difference_type difference_type;
+                typedef void pointer;
+                typedef typename MyDeque::const_reference reference;
+
+            public:
+                // -----------
+                // operator ==
+                // -----------
+
+                friend bool operator == (const const_iterator& lhs, const const_iterator& rhs) {
+                    return (lhs._x == rhs._x) && (lhs._i == rhs._i);}
+
+                friend bool operator != (const const_iterator& lhs, const const_iterator& rhs) {
+                    return !(lhs == rhs);}
+
+                // ----------
+                // operator +
+                // ----------
+
+                friend const_iterator operator + (const_iterator lhs, difference_type rhs) {
+                    return lhs += rhs;}
+
+                // ----------
+                // operator -
+                // ----------
+
+                friend const_iterator operator - (const_iterator lhs, difference_type rhs) {
+                    return lhs -= rhs;}
+
+            private:
+                // ----
+                // data
+                // ----
+
+                const MyDeque* _x;
+                size_type _i;
+
+            public:
+                // -----------
+                // constructor
+                // -----------
+
+                const_iterator (const MyDeque* x, size_type i) : _x(x), _i(i) {}
+
+                // Default copy, destructor, and copy assignment.
+                // const_iterator (const const_iterator&);
+                // ~const_iterator ();
+                // const_iterator& operator = (const const_iterator&);
+
+                reference operator * () const {
+                    return (*_x)[_i];}
+
+                const_iterator& operator ++ () {
+                    ++_i;
+                    return *this;}
+
+                const_iterator operator ++ (int) {
+                    const_iterator x = *this;
+                    ++(*this);
+                    return x;}
+
+                const_iterator& operator -- () {
+                    --_i;
+                    return *this;}
+
+                const_iterator operator -- (int) {
+                    const_iterator x = *this;
+                    --(*this);
+                    return x;}
+
+                const_iterator& operator += (difference_type d) {
+                    _i += d;
+                    return *this;}
+
+                const_iterator& operator -= (difference_type d) {
+                    _i -= d;
+                    return *this;}};
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        explicit MyDeque (const allocator_type& a = allocator_type()) : _w(a), _off(0), _size(0), _front_seq(0), _gen(0) {
+            assert(valid());}
+
+        /**
+	 * @param s the number of flags
+	 * @param v the value of each
+	 * @param a the allocator to use
+	 */
+        explicit MyDeque (size_type s, const_reference v = false, const allocator_type& a = allocator_type()) :
+                _w((s + bitsPerWord - 1) / bitsPerWord, v ? ~word(0) : word(0), a), _off(0), _size(s), _front_seq(0), _gen(0) {
+            if (v && (s % bitsPerWord))
+                _w.back() = (word(1) << (s % bitsPerWord)) - 1;
+            assert(valid());}
+
+        // Default copy, destructor, and copy assignment.
+        // MyDeque (const MyDeque&);
+        // ~MyDeque ();
+        // MyDeque& operator = (const MyDeque&);
+
+        // -----------
+        // operator []
+        // -----------
+
+        reference operator [] (size_type index) {
+            assert(index < _size);
+            const size_type g = _off + index;
+            return reference(&_w[g / bitsPerWord], word(1) << (g % bitsPerWord));}
+
+        const_reference operator [] (size_type index) const {
+            assert(index < _size);
+            const size_type g = _off + index;
+            return (_w[g / bitsPerWord] >> (g % bitsPerWord)) & 1;}
+
+        // --
+        // at
+        // --
+
+        /**
+	 * @throw out_of_range if index is not less than size()
+	 */
+        reference at (size_type index) {
+            if (index >= _size)
+                throw std::out_of_range("MyDeque::at index out of range");
+            return (*this)[index];}
+
+        const_reference at (size_type index) const {
+            if (index >= _size)
+                throw std::out_of_range("MyDeque::at index out of range");
+            return (*this)[index];}
+
+        // ----
+        // back
+        // ----
+
+        reference back () {
+            assert(!empty());
+            return (*this)[_size - 1];}
+
+        const_reference back () const {
+            assert(!empty());
+            return (*this)[_size - 1];}
+
+        // -----
+        // begin
+        // -----
+
+        iterator begin () {
+            return iterator(this, 0);}
+
+        const_iterator begin () const {
+            return const_iterator(this, 0);}
+
+        // -----
+        // clear
+        // -----
+
+        void clear () {
+            retire_handles();
+            _size = 0;
+            normalize();
+            assert(valid());}
+
+        // -----
+        // count
+        // -----
+
+        /**
+	 * counts a row of words at a time
+	 * @return the number of flags that are set
+	 */
+        size_type count () const {
+            size_type c = 0;
+            size_type n;
+            for (size_type i = 0; i != _w.size(); i += n) {
+                const word* p = _w.segment(i, n);
+                c += popcount_kernel(p, n);}
+            return c;}
+
+        // -----
+        // drain
+        // -----
+
+        /**
+	 * moves up to n flags off the back, last first, then releases their
+	 * words with a single pop_back_n
+	 * @param n the most flags to take
+	 * @param out where the flags are copied to, as bool
+	 * @return out past the copied flags
+	 */
+        template <typename OI>
+        OI drain_back (size_type n, OI out) {
+            n = std::min(n, _size);
+            for (size_type i = _size; i != _size - n; --i, ++out)
+                *out = (*this)[i - 1];
+            pop_back_n(n);
+            return out;}
+
+        /**
+	 * moves up to n flags off the front, first first, then releases their
+	 * words with a single pop_front_n
+	 * @param n the most flags to take
+	 * @param out where the flags are copied to, as bool
+	 * @return out past the copied flags
+	 */
+        template <typename OI>
+        OI drain_front (size_type n, OI out) {
+            n = std::min(n, _size);
+            for (size_type i = 0; i != n; ++i, ++out)
+                *out = (*this)[i];
+            pop_front_n(n);
+            return out;}
+
+        // -----
+        // empty
+        // -----
+
+        bool empty () const {
+            return !_size;}
+
+        // ---
+        // end
+        // ---
+
+        iterator end () {
+            return iterator(this, _size);}
+
+        const_iterator end () const {
+            return const_iterator(this, _size);}
+
+        // -----
+        // erase
+        // -----
+
+        /**
+	 * removes the flag at i, shifting the flags on its shorter side over it
+	 * @return an iterator to the flag that followed it
+	 */
+        iterator erase (iterator i) {
+            const size_type k = i._i;
+            assert(k < _size);
+            if (k < _size - k - 1) {
+                for (size_type j = k; j != 0; --j)
+                    (*this)[j] = bool((*this)[j - 1]);
+                pop_front();}
+            else {
+                for (size_type j = k; j != _size - 1; ++j)
+                    (*this)[j] = bool((*this)[j + 1]);
+                pop_back();}
+            return iterator(this, k);}
+
+        // ----------
+        // find_first
+        // ----------
+
+        /**
+	 * scans a word at a time
+	 * @return the index of the first flag equal to v, or size()
+	 */
+        size_type find_first (bool v = true) const {
+            const size_type e = _off + _size;
+            size_type n;
+            for (size_type i = 0; i != _w.size(); i += n) {
+                const word* p = _w.segment(i, n);
+                for (size_type j = 0; j != n; ++j) {
+                    word w = v ? p[j] : ~p[j];
+                    if (!(i + j))
+                        w &= ~word(0) << _off;
+                    if (w) {
+                        const size_type g = (i + j) * bitsPerWord + lowest_bit(w);
+                        return (g < e) ? g - _off : _size;}}}
+            return _size;}
+
+        // -----
+        // front
+        // -----
+
+        reference front () {
+            assert(!empty());
+            return (*this)[0];}
+
+        const_reference front () const {
+            assert(!empty());
+            return (*this)[0];}
+
+        // -------------
+        // get_allocator
+        // -------------
+
+        allocator_type get_allocator () const {
+            return allocator_type(_w.get_allocator());}
+
+        // -------
+        // handles
+        // -------
+
+        /**
+	 * The same handles as MyDeque<T>'s, following a flag across pushes and
+	 * pops at either end, split_at and splice_front, and never contained
+	 * again after clear; a push after a pop at the same end reuses the
+	 * popped flag's handle.
+	 * @param index the index of a flag
+	 * @return a handle to that flag
+	 */
+        handle_type handle (size_type index) const {
+            assert(index < _size);
+            return handle_type(_front_seq + index, _gen);}
+
+        /**
+	 * @return true if h names a flag of this MyDeque
+	 */
+        bool contains (handle_type h) const {
+            return (h.gen == _gen) && (size_type(h.seq - _front_seq) < _size);}
+
+        /**
+	 * @return the current index of the flag h names, which must be contained
+	 */
+        size_type position (handle_type h) const {
+            assert(contains(h));
+            return h.seq - _front_seq;}
+
+        /**
+	 * @return the flag h names, which must be contained
+	 */
+        reference get (handle_type h) {
+            return (*this)[position(h)];}
+
+        const_reference get (handle_type h) const {
+            return (*this)[position(h)];}
+
+        // ------
+        // insert
+        // ------
+
+        /**
+	 * inserts v before i, shifting the flags on its shorter side to make room
+	 * @return an iterator to the inserted flag
+	 */
+        iterator insert (iterator i, const_reference v) {
+            const size_type k = i._i;
+            assert(k <= _size);
+            if (k < _size - k) {
+                push_front(false);
+                for (size_type j = 0; j != k; ++j)
+                    (*this)[j] = bool((*this)[j + 1]);}
+            else {
+                push_back(false);
+                for (size_type j = _size - 1; j != k; --j)
+                    (*this)[j] = bool((*this)[j - 1]);}
+            (*this)[k] = v;
+            return iterator(this, k);}
+
+        // --------
+        // pop_back
+        // --------
+
+        void pop_back () {
+            pop_back_n(1);}
+
+        /**
+	 * removes the last n flags; the words they leave empty go in one
+	 * pop_back_n of the word deque, which frees them a row at a time
+	 * @param n at most size()
+	 */
+        void pop_back_n (size_type n) {
+            assert(n <= _size);
+            _size -= n;
+            const size_type e = _off + _size;
+            const size_type words = (e + bitsPerWord - 1) / bitsPerWord;
+            _w.pop_back_n(_w.size() - words);
+            if (e % bitsPerWord)
+                _w.back() &= (word(1) << (e % bitsPerWord)) - 1;
+            normalize();
+            assert(valid());}
+
+        // ---------
+        // pop_front
+        // ---------
+
+        void pop_front () {
+            pop_front_n(1);}
+
+        /**
+	 * removes the first n flags; the words they leave empty go in one
+	 * pop_front_n of the word deque, which frees them a row at a time
+	 * @param n at most size()
+	 */
+        void pop_front_n (size_type n) {
+            assert(n <= _size);
+            const size_type g = _off + n;
+            _w.pop_front_n(g / bitsPerWord);
+            _off = g % bitsPerWord;
+            _size -= n;
+            _front_seq += n;
+            if (_off)
+                _w.front() &= ~word(0) << _off;
+            normalize();
+            assert(valid());}
+
+        // ---------
+        // push_back
+        // ---------
+
+        void push_back (const_reference v) {
+            if (!((_off + _size) % bitsPerWord))
+                _w.push_back(0);
+            ++_size;
+            (*this)[_size - 1] = v;
+            assert(valid());}
+
+        // ----------
+        // push_front
+        // ----------
+
+        void push_front (const_reference v) {
+            if (!_off) {
+                _w.push_front(0);
+                _off = bitsPerWord;}
+            --_off;
+            ++_size;
+            --_front_seq;
+            (*this)[0] = v;
+            assert(valid());}
+
+        // ------
+        // resize
+        // ------
+
+        /**
+	 * @param s the new size
+	 * @param v the value of added flags, which are appended a word at a time
+	 */
+        void resize (size_type s, const_reference v = false) {
+            if (s <= _size) {
+                pop_back_n(_size - s);
+                return;}
+            while ((_size != s) && ((_off + _size) % bitsPerWord))
+                push_back(v);
+            for (; s - _size >= size_type(bitsPerWord); _size += bitsPerWord)
+                _w.push_back(v ? ~word(0) : word(0));
+            while (_size != s)
+                push_back(v);
+            assert(valid());}
+
+        // ----
+        // size
+        // ----
+
+        size_type size () const {
+            return _size;}
+
+        // -------
+        // segment
+        // -------
+
+        /**
+	 * The packed analogue of MyDeque<T>::segment: flag index is bit
+	 * (offset() + index) % bitsPerWord of the word returned, and the flags
+	 * after it follow on in that word and the ones after it.
+	 * @param index the index of a flag
+	 * @param n set to the number of flags from index to the end of its row of words or of the MyDeque, whichever comes first
+	 * @return a read-only pointer to the word holding flag index, followed contiguously by the rest of its row
+	 */
+        const word* segment (size_type index, size_type& n) const {
+            assert(index < _size);
+            const size_type g = _off + index;
+            size_type m;
+            const word* const p = _w.segment(g / bitsPerWord, m);
+            n = std::min(m * bitsPerWord - g % bitsPerWord, _size - index);
+            return p;}
+
+        word* segment (size_type index, size_type& n) {
+            return const_cast<word*>(const_cast<const MyDeque*>(this)->segment(index, n));}
+
+        // ------
+        // splice
+        // ------
+
+        /**
+	 * appends that's flags to this MyDeque, leaving that empty
+	 * when that's first flag sits in the bit right after this MyDeque's
+	 * last one, the words are spliced, merging at most the boundary word;
+	 * otherwise that's flags are appended one at a time
+	 */
+        void splice_back (MyDeque& that) {
+            if ((this == &that) || that.empty())
+                return;
+            if (empty() && (get_allocator() == that.get_allocator())) {
+                swap(that);
+                that.clear();
+                return;}
+            const size_type e = (_off + _size) % bitsPerWord;
+            if (e != that._off) {
+                for (size_type i = 0; i != that._size; ++i)
+                    push_back(that[i]);
+                that.clear();
+                return;}
+            if (e) {
+                _w.back() |= that._w.front();
+                that._w.pop_front();}
+            _w.splice_back(that._w);
+            _size += that._size;
+            that.retire_handles();
+            that._size = 0;
+            that.normalize();
+            assert(valid());}
+
+        /**
+	 * prepends that's flags to this MyDeque, leaving that empty
+	 * when that's last flag sits in the bit right before this MyDeque's
+	 * first one, the words are spliced, merging at most the boundary word;
+	 * otherwise that's flags are prepended one at a time
+	 */
+        void splice_front (MyDeque& that) {
+            if ((this == &that) || that.empty())
+                return;
+            if (empty() && (get_allocator() == that.get_allocator())) {
+                swap(that);
+                that.clear();
+                return;}
+            const size_type e = (that._off + that._size) % bitsPerWord;
+            if (e != _off) {
+                for (size_type i = that._size; i != 0; --i)
+                    push_front(that[i - 1]);
+                that.clear();
+                return;}
+            if (_off) {
+                _w.front() |= that._w.back();
+                that._w.pop_back();}
+            _w.splice_front(that._w);
+            _off = that._off;
+            _size += that._size;
+            _front_seq -= that._size;
+            that.retire_handles();
+            that._size = 0;
+            that.normalize();
+            assert(valid());}
+
+        // --------
+        // split_at
+        // --------
+
+        /**
+	 * removes the flags from pos onward and returns them in a new MyDeque
+	 * whole rows of words are handed over; only the word holding pos is copied
+	 * @throw out_of_range exception if pos is greater than size()
+	 */
+        MyDeque split_at (size_type pos) {
+            if (pos > _size)
+                throw std::out_of_range("MyDeque::split_at(pos)");
+            MyDeque x(get_allocator());
+            const size_type g = _off + pos;
+            word_container t = _w.split_at(g / bitsPerWord);
+            x._w.swap(t);
+            x._off = g % bitsPerWord;
+            x._size = _size - pos;
+            x._front_seq = _front_seq + pos;
+            x._gen = _gen;
+            _size = pos;
+            if (x._off) {
+                const word low = (word(1) << x._off) - 1;
+                _w.push_back(x._w.front() & low);
+                x._w.front() &= ~low;}
+            normalize();
+            x.normalize();
+            assert(valid());
+            assert(x.valid());
+            return x;}
+
+        // ----
+        // swap
+        // ----
+
+        void swap (MyDeque& that) {
+            _w.swap(that._w);
+            std::swap(_off, that._off);
+            std::swap(_size, that._size);
+            std::swap(_front_seq, that._front_seq);
+            std::swap(_gen, that._gen);}
+
+        // -----
+        // words
+        // -----
+
+        /**
+	 * @return the packed words; flag i is bit words()[(offset() + i) / bitsPerWord] at (offset() + i) % bitsPerWord
+	 */
+        const word_container& words () const {
+            return _w;}
+
+        /**
+	 * @return the bit of words().front() that holds the first flag
+	 */
+        size_type offset () const {
+            return _off;}};
+
+/**
+ * @return the number of flags of x equal to v
+ */
+template <typename A>
+typename MyDeque<bool, A>::size_type count (const MyDeque<bool, A>& x, bool v) {
+    const typename MyDeque<bool, A>::size_type c = x.count();
+    return v ? c : x.size() - c;}
+
+/**
+ * @return the index of the first flag of x equal to v, or x.size()
+ */
+template <typename A>
+typename MyDeque<bool, A>::size_type find_index (const MyDeque<bool, A>& x, bool v) {
+    return x.find_first(v);}
+
+/**
+ * @return true if every flag of x, which must not be empty, is set
+ */
+template <typename A>
+bool min (const MyDeque<bool, A>& x) {
+    assert(!x.empty());
+    return x.find_first(false) == x.size();}
+
+/**
+ * @return true if any flag of x, which must not be empty, is set
+ */
+template <typename A>
+bool max (const MyDeque<bool, A>& x) {
+    assert(!x.empty());
+    return x.find_first(true) != x.size();}
+
+/**
+ * @return the sum of the flags of x as a bool, true if any flag is set
+ */
+template <typename A>
+bool sum (const MyDeque<bool, A>& x) {
+    return x.find_first(true) != x.size();}
+
 #endif // Deque_h
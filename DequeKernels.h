@@ -0,0 +1,337 @@
+// -----------------------------
+// projects/deque/DequeKernels.h
+// Copyright (C) 2012
+// Glenn P. Downing
+// -----------------------------
+
+#ifndef DequeKernels_h
+#define DequeKernels_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef> // size_t
+#include <stdint.h> // uint64_t
+
+/*
+Loops over one contiguous run of elements, used by MyDeque row by row.
+
+On x86 with g++ the int, float, double and uint64_t kernels are written
+with vector extensions and compiled twice, for AVX2 and for the baseline
+(SSE2 on x86-64); the loader picks one at run time. Every other type,
+compiler or machine, or a build with -DDEQUE_NO_SIMD, uses the scalar
+loops. The vector sum of float and double adds in a different order than
+the scalar loop, and the vector min and max do not order NaNs.
+*/
+
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__)) && !defined(DEQUE_NO_SIMD)
+#define DEQUE_SIMD
+#endif
+
+// -----------
+// simd_vector
+// -----------
+
+/**
+ * value is true for the element types that have vector kernels;
+ * type is a 32-byte vector of them and mask what comparing two gives
+ */
+template <typename T>
+struct simd_vector {
+    enum {value = false};};
+
+#ifdef DEQUE_SIMD
+
+template <>
+struct simd_vector<int> {
+    enum {value = true};
+    typedef int type __attribute__((vector_size(32)));
+    typedef int mask __attribute__((vector_size(32)));};
+
+template <>
+struct simd_vector<float> {
+    enum {value = true};
+    typedef float type __attribute__((vector_size(32)));
+    typedef int mask __attribute__((vector_size(32)));};
+
+template <>
+struct simd_vector<double> {
+    enum {value = true};
+    typedef double type __attribute__((vector_size(32)));
+    typedef int64_t mask __attribute__((vector_size(32)));};
+
+template <>
+struct simd_vector<uint64_t> {
+    enum {value = true};
+    typedef uint64_t type __attribute__((vector_size(32)));
+    typedef int64_t mask __attribute__((vector_size(32)));};
+
+#define DEQUE_DISPATCH __attribute__((target_clones("avx2", "default")))
+
+#endif // DEQUE_SIMD
+
+template <bool B>
+struct simd_tag {};
+
+// ------
+// scalar
+// ------
+
+template <typename T>
+std::size_t find_kernel (const T* b, std::size_t n, const T& v, simd_tag<false>) {
+    std::size_t i = 0;
+    while ((i != n) && !(b[i] == v))
+        ++i;
+    return i;}
+
+template <typename T>
+std::size_t count_kernel (const T* b, std::size_t n, const T& v, simd_tag<false>) {
+    std::size_t c = 0;
+    for (std::size_t i = 0; i != n; ++i)
+        if (b[i] == v)
+            ++c;
+    return c;}
+
+template <typename T>
+T min_kernel (const T* b, std::size_t n, T m, simd_tag<false>) {
+    for (std::size_t i = 0; i != n; ++i)
+        if (b[i] < m)
+            m = b[i];
+    return m;}
+
+template <typename T>
+T max_kernel (const T* b, std::size_t n, T m, simd_tag<false>) {
+    for (std::size_t i = 0; i != n; ++i)
+        if (m < b[i])
+            m = b[i];
+    return m;}
+
+template <typename T>
+T sum_kernel (const T* b, std::size_t n, T s, simd_tag<false>) {
+    for (std::size_t i = 0; i != n; ++i)
+        s = s + b[i];
+    return s;}
+
+template <typename T>
+std::size_t mismatch_kernel (const T* a, const T* b, std::size_t n, simd_tag<false>) {
+    std::size_t i = 0;
+    while ((i != n) && (a[i] == b[i]))
+        ++i;
+    return i;}
+
+// --------
+// popcount
+// --------
+
+/**
+ * @return the number of bits set in the words of [b, b + n)
+ */
+template <typename W>
+#ifdef DEQUE_SIMD
+DEQUE_DISPATCH // the AVX2 clone also has the popcnt instruction
+#endif
+std::size_t popcount_kernel (const W* b, std::size_t n) {
+    std::size_t c = 0;
+    for (std::size_t i = 0; i != n; ++i) {
+#ifdef __GNUC__
+        c += __builtin_popcountl(b[i]);
+#else
+        for (W w = b[i]; w; w &= w - 1)
+            ++c;
+#endif
+        }
+    return c;}
+
+#ifdef DEQUE_SIMD
+
+// ------
+// vector
+// ------
+
+// Vectors are passed by reference so that a helper that is not inlined
+// has the same calling convention in the AVX2 and the baseline clones.
+
+template <typename V, typename T>
+void splat (V& x, const T& v) {
+    for (std::size_t k = 0; k != sizeof(V) / sizeof(T); ++k)
+        x[k] = v;}
+
+template <typename V, typename T>
+void load (V& x, const T* p) {
+    __builtin_memcpy(&x, p, sizeof(V));}
+
+template <typename M>
+bool any (const M& m) {
+    typedef unsigned long word __attribute__((vector_size(32)));
+    word w;
+    __builtin_memcpy(&w, &m, sizeof(w));
+    unsigned long r = 0;
+    for (std::size_t k = 0; k != sizeof(w) / sizeof(unsigned long); ++k)
+        r |= w[k];
+    return r;}
+
+template <typename T>
+DEQUE_DISPATCH
+std::size_t find_kernel (const T* b, std::size_t n, const T& v, simd_tag<true>) {
+    typedef typename simd_vector<T>::type V;
+    const std::size_t w = sizeof(V) / sizeof(T);
+    V x;
+    splat(x, v);
+    std::size_t i = 0;
+    for (; i + 4 * w <= n; i += 4 * w) {
+        V y0, y1, y2, y3;
+        load(y0, b + i);
+        load(y1, b + i + w);
+        load(y2, b + i + 2 * w);
+        load(y3, b + i + 3 * w);
+        if (any((y0 == x) | (y1 == x) | (y2 == x) | (y3 == x)))
+            break;}
+    while ((i != n) && !(b[i] == v))
+        ++i;
+    return i;}
+
+template <typename T>
+DEQUE_DISPATCH
+std::size_t count_kernel (const T* b, std::size_t n, const T& v, simd_tag<true>) {
+    typedef typename simd_vector<T>::type V;
+    typedef typename simd_vector<T>::mask M;
+    const std::size_t w = sizeof(V) / sizeof(T);
+    V x;
+    splat(x, v);
+    M c = M();
+    std::size_t i = 0;
+    for (; i + w <= n; i += w) {
+        V y;
+        load(y, b + i);
+        c -= (y == x);}
+    std::size_t r = 0;
+    for (std::size_t k = 0; k != w; ++k)
+        r += c[k];
+    for (; i != n; ++i)
+        if (b[i] == v)
+            ++r;
+    return r;}
+
+template <typename T>
+DEQUE_DISPATCH
+T min_kernel (const T* b, std::size_t n, T m, simd_tag<true>) {
+    typedef typename simd_vector<T>::type V;
+    const std::size_t w = sizeof(V) / sizeof(T);
+    std::size_t i = 0;
+    if (n >= w) {
+        V x;
+        splat(x, m);
+        for (; i + w <= n; i += w) {
+            V y;
+            load(y, b + i);
+            x = (y < x) ? y : x;}
+        for (std::size_t k = 0; k != w; ++k)
+            if (x[k] < m)
+                m = x[k];}
+    return min_kernel(b + i, n - i, m, simd_tag<false>());}
+
+template <typename T>
+DEQUE_DISPATCH
+T max_kernel (const T* b, std::size_t n, T m, simd_tag<true>) {
+    typedef typename simd_vector<T>::type V;
+    const std::size_t w = sizeof(V) / sizeof(T);
+    std::size_t i = 0;
+    if (n >= w) {
+        V x;
+        splat(x, m);
+        for (; i + w <= n; i += w) {
+            V y;
+            load(y, b + i);
+            x = (x < y) ? y : x;}
+        for (std::size_t k = 0; k != w; ++k)
+            if (m < x[k])
+                m = x[k];}
+    return max_kernel(b + i, n - i, m, simd_tag<false>());}
+
+template <typename T>
+DEQUE_DISPATCH
+T sum_kernel (const T* b, std::size_t n, T s, simd_tag<true>) {
+    typedef typename simd_vector<T>::type V;
+    const std::size_t w = sizeof(V) / sizeof(T);
+    V x = V();
+    V y = V();
+    std::size_t i = 0;
+    for (; i + 2 * w <= n; i += 2 * w) {
+        V z0, z1;
+        load(z0, b + i);
+        load(z1, b + i + w);
+        x += z0;
+        y += z1;}
+    x += y;
+    for (std::size_t k = 0; k != w; ++k)
+        s = s + x[k];
+    return sum_kernel(b + i, n - i, s, simd_tag<false>());}
+
+template <typename T>
+DEQUE_DISPATCH
+std::size_t mismatch_kernel (const T* a, const T* b, std::size_t n, simd_tag<true>) {
+    typedef typename simd_vector<T>::type V;
+    const std::size_t w = sizeof(V) / sizeof(T);
+    std::size_t i = 0;
+    for (; i + 2 * w <= n; i += 2 * w) {
+        V x0, x1, y0, y1;
+        load(x0, a + i);
+        load(x1, a + i + w);
+        load(y0, b + i);
+        load(y1, b + i + w);
+        if (any((x0 != y0) | (x1 != y1)))
+            break;}
+    while ((i != n) && (a[i] == b[i]))
+        ++i;
+    return i;}
+
+#endif // DEQUE_SIMD
+
+// --------
+// dispatch
+// --------
+
+/**
+ * @return the index of the first element of [b, b + n) equal to v, or n
+ */
+template <typename T>
+std::size_t find_kernel (const T* b, std::size_t n, const T& v) {
+    return find_kernel(b, n, v, simd_tag<simd_vector<T>::value>());}
+
+/**
+ * @return the number of elements of [b, b + n) equal to v
+ */
+template <typename T>
+std::size_t count_kernel (const T* b, std::size_t n, const T& v) {
+    return count_kernel(b, n, v, simd_tag<simd_vector<T>::value>());}
+
+/**
+ * @return the smallest of m and the elements of [b, b + n)
+ */
+template <typename T>
+T min_kernel (const T* b, std::size_t n, const T& m) {
+    return min_kernel(b, n, m, simd_tag<simd_vector<T>::value>());}
+
+/**
+ * @return the largest of m and the elements of [b, b + n)
+ */
+template <typename T>
+T max_kernel (const T* b, std::size_t n, const T& m) {
+    return max_kernel(b, n, m, simd_tag<simd_vector<T>::value>());}
+
+/**
+ * @return s plus the elements of [b, b + n)
+ */
+template <typename T>
+T sum_kernel (const T* b, std::size_t n, const T& s) {
+    return sum_kernel(b, n, s, simd_tag<simd_vector<T>::value>());}
+
+/**
+ * @return the first index at which [a, a + n) and [b, b + n) differ, or n
+ */
+template <typename T>
+std::size_t mismatch_kernel (const T* a, const T* b, std::size_t n) {
+    return mismatch_kernel(a, b, n, simd_tag<simd_vector<T>::value>());}
+
+#endif // DequeKernels_h
@@ -0,0 +1,249 @@
+// -------------------------
+// projects/deque/Executor.h
+// Copyright (C) 2012
+// Glenn P. Downing
+// -------------------------
+
+#ifndef Executor_h
+#define Executor_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <cstddef> // size_t
+#include <pthread.h> // pthread_cond_t, pthread_mutex_t, pthread_t
+#include <stdexcept> // runtime_error
+#include <vector> // vector
+
+#include "Deque.h"
+
+// ----
+// Task
+// ----
+
+/**
+ * A resumable unit of work, such as one stage of a pipeline. A Task keeps
+ * its own state between runs, so run() picks up where the last one stopped.
+ * Once run() has handed the Task to an Executor or an AsyncDeque it may be
+ * resumed on another thread, so it must return without touching its state.
+ */
+struct Task {
+    virtual ~Task () {}
+
+    virtual void run () = 0;};
+
+// --------
+// Executor
+// --------
+
+/**
+ * Runs the Tasks that are posted to it.
+ */
+struct Executor {
+    virtual ~Executor () {}
+
+    /**
+     * arranges for t->run() to be called; a Task may be posted again only after it has started running
+     */
+    virtual void post (Task* t) = 0;};
+
+// -----
+// Mutex
+// -----
+
+class Mutex {
+    friend class Condition;
+
+    private:
+        pthread_mutex_t _m;
+
+        Mutex (const Mutex&);
+        Mutex& operator = (const Mutex&);
+
+    public:
+        Mutex () {
+            pthread_mutex_init(&_m, 0);}
+
+        ~Mutex () {
+            pthread_mutex_destroy(&_m);}
+
+        void lock () {
+            pthread_mutex_lock(&_m);}
+
+        void unlock () {
+            pthread_mutex_unlock(&_m);}};
+
+// ----
+// Lock
+// ----
+
+/**
+ * holds a Mutex for the lifetime of the Lock
+ */
+class Lock {
+    private:
+        Mutex& _m;
+
+        Lock (const Lock&);
+        Lock& operator = (const Lock&);
+
+    public:
+        explicit Lock (Mutex& m) : _m(m) {
+            _m.lock();}
+
+        ~Lock () {
+            _m.unlock();}};
+
+// ---------
+// Condition
+// ---------
+
+class Condition {
+    private:
+        pthread_cond_t _c;
+
+        Condition (const Condition&);
+        Condition& operator = (const Condition&);
+
+    public:
+        Condition () {
+            pthread_cond_init(&_c, 0);}
+
+        ~Condition () {
+            pthread_cond_destroy(&_c);}
+
+        /**
+	 * releases m, which must be held, until signaled, then takes it again
+	 */
+        void wait (Mutex& m) {
+            pthread_cond_wait(&_c, &m._m);}
+
+        void signal () {
+            pthread_cond_signal(&_c);}
+
+        void broadcast () {
+            pthread_cond_broadcast(&_c);}};
+
+// ------------
+// LoopExecutor
+// ------------
+
+/**
+ * A single-threaded Executor: posted Tasks wait in a MyDeque until run()
+ * is called, which runs them in order, along with any they post, until
+ * none is left. Not safe to post to from another thread.
+ */
+class LoopExecutor : public Executor {
+    private:
+        MyDeque<Task*> _ready;
+
+    public:
+        void post (Task* t) {
+            assert(t);
+            _ready.push_back(t);}
+
+        /**
+	 * @return the number of Tasks that were run
+	 */
+        std::size_t run () {
+            std::size_t n = 0;
+            while (!_ready.empty()) {
+                Task* const t = _ready.front();
+                _ready.pop_front();
+                t->run();
+                ++n;}
+            return n;}
+
+        bool empty () const {
+            return _ready.empty();}};
+
+// ------------------
+// ThreadPoolExecutor
+// ------------------
+
+/**
+ * An Executor that runs posted Tasks on a fixed number of threads, so that
+ * many Tasks share a few cores. The threads are joined on destruction.
+ */
+class ThreadPoolExecutor : public Executor {
+    private:
+        Mutex _m;
+        Condition _ready_c;
+        Condition _idle_c;
+
+        MyDeque<Task*> _ready;
+        std::vector<pthread_t> _threads;
+
+        // Tasks that are posted or running
+        std::size_t _busy;
+        bool _stop;
+
+        ThreadPoolExecutor (const ThreadPoolExecutor&);
+        ThreadPoolExecutor& operator = (const ThreadPoolExecutor&);
+
+    private:
+        static void* work (void* p) {
+            ThreadPoolExecutor& e = *static_cast<ThreadPoolExecutor*>(p);
+            for (;;) {
+                Task* t;
+                {
+                Lock l(e._m);
+                while (e._ready.empty() && !e._stop)
+                    e._ready_c.wait(e._m);
+                if (e._ready.empty())
+                    return 0;
+                t = e._ready.front();
+                e._ready.pop_front();
+                }
+                t->run();
+                Lock l(e._m);
+                if (!--e._busy)
+                    e._idle_c.broadcast();}}
+
+        void stop () {
+            {
+            Lock l(_m);
+            _stop = true;
+            _ready_c.broadcast();
+            }
+            for (std::size_t i = 0; i != _threads.size(); ++i)
+                pthread_join(_threads[i], 0);}
+
+    public:
+        /**
+	 * @param n the number of threads
+	 * @throw runtime_error if a thread cannot be started
+	 */
+        explicit ThreadPoolExecutor (std::size_t n) : _busy(0), _stop(false) {
+            assert(n);
+            for (std::size_t i = 0; i != n; ++i) {
+                pthread_t t;
+                if (pthread_create(&t, 0, work, this)) {
+                    stop();
+                    throw std::runtime_error("ThreadPoolExecutor: pthread_create failed");}
+                _threads.push_back(t);}}
+
+        /**
+	 * runs the Tasks still posted, then joins the threads
+	 */
+        ~ThreadPoolExecutor () {
+            stop();}
+
+        void post (Task* t) {
+            assert(t);
+            Lock l(_m);
+            _ready.push_back(t);
+            ++_busy;
+            _ready_c.signal();}
+
+        /**
+	 * blocks until no Task is posted or running; Tasks parked on an AsyncDeque do not count
+	 */
+        void wait () {
+            Lock l(_m);
+            while (_busy)
+                _idle_c.wait(_m);}};
+
+#endif // Executor_h
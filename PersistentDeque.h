@@ -0,0 +1,714 @@
+// --------------------------------
+// projects/deque/PersistentDeque.h
+// Copyright (C) 2012
+// Glenn P. Downing
+// --------------------------------
+
+#ifndef PersistentDeque_h
+#define PersistentDeque_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max
+#include <cassert> // assert
+#include <memory> // allocator
+#include <stdexcept> // out_of_range
+#include <utility> // pair
+
+// ---------------
+// PersistentDeque
+// ---------------
+
+/**
+ * An immutable deque: every modifier is const and returns a new version,
+ * leaving the old one intact. Versions share structure:
+ * elements live in fixed-size chunks (the analogue of MyDeque's rows),
+ * a version sees a slice [b, e) of each chunk it uses, and the chunks in
+ * the middle of the deque hang off a persistent AVL tree that is path
+ * copied on update. The front and back slices are extended in place when
+ * the version owns the tip of its chunk, so push and pop at either end
+ * are O(1) amortized (one O(log n) tree update per chunk), while indexing,
+ * concat and split_at are O(log n).
+ * Reference counts and the extension of shared chunks are not synchronized,
+ * so versions that share structure may be read (size, [], at, front, back)
+ * from many threads at once, but must not be copied, assigned, destroyed,
+ * pushed, popped, concatenated or split concurrently with each other.
+ */
+template < typename T, typename A = std::allocator<T> >
+class PersistentDeque {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef A allocator_type;
+        typedef typename allocator_type::value_type value_type;
+
+        typedef typename allocator_type::size_type size_type;
+        typedef typename allocator_type::difference_type difference_type;
+
+        typedef typename allocator_type::pointer pointer;
+        typedef typename allocator_type::const_pointer const_pointer;
+
+        typedef typename allocator_type::reference reference;
+        typedef typename allocator_type::const_reference const_reference;
+
+    public:
+        // -----------
+        // operator ==
+        // -----------
+
+        /**
+         * @param lhs PersistentDeque to compare to rhs
+         * @param rhs PersistentDeque to test equality with lhs
+         * @return True if both versions are the same size and have the same contents
+         */
+        friend bool operator == (const PersistentDeque& lhs, const PersistentDeque& rhs) {
+            if (lhs.size() != rhs.size())
+                return false;
+            for (size_type i = 0; i != lhs.size(); ++i)
+                if (!(lhs[i] == rhs[i]))
+                    return false;
+            return true;}
+
+    private:
+        // -----
+        // Chunk
+        // -----
+
+        /**
+         * A fixed-capacity array shared by every slice that points into it.
+         * Only [lo, hi) is constructed; it grows outward, and shrinks back
+         * only when no version sees the elements given up (see reclaim_back).
+         */
+        struct Chunk {
+            size_type refs;
+            allocator_type a;
+            pointer data;
+            size_type capacity;
+            size_type lo;
+            size_type hi;};
+
+        // -----
+        // Slice
+        // -----
+
+        struct Slice {
+            Chunk* c;
+            size_type b;
+            size_type e;};
+
+        // ----
+        // Node
+        // ----
+
+        struct Node {
+            size_type refs;
+            size_type height;
+            size_type size;
+            Node* left;
+            Node* right;
+            Slice s;};
+
+    private:
+        // ----
+        // data
+        // ----
+
+        allocator_type _a;
+        size_type _blockSize;
+        size_type _size;
+
+        Slice _front;
+        Node* _tree;
+        Slice _back;
+
+    private:
+        // -----
+        // valid
+        // -----
+
+        bool valid () const {
+            return (_blockSize > 0) &&
+                   (_size == length(_front) + size(_tree) + length(_back)) &&
+                   (!_front.c || _front.b < _front.e) &&
+                   (!_back.c  || _back.b  < _back.e);}
+
+        // ------
+        // chunks
+        // ------
+
+        static Slice empty_slice () {
+            Slice s = {0, 0, 0};
+            return s;}
+
+        static size_type length (const Slice& s) {
+            return s.e - s.b;}
+
+        static void retain (Chunk* c) {
+            if (c)
+                ++c->refs;}
+
+        static void release (Chunk* c) {
+            if (c && !--c->refs) {
+                for (size_type i = c->lo; i != c->hi; ++i)
+                    c->a.destroy(c->data + i);
+                c->a.deallocate(c->data, c->capacity);
+                delete c;}}
+
+        /**
+         * @param at the index of the first element in the new chunk, 0 for
+         *        a chunk growing backward or _blockSize for one growing forward
+         * @return a slice holding v as the only element of a new chunk
+         */
+        Slice make_slice (const_reference v, size_type at) const {
+            Chunk* c = new Chunk;
+            c->refs = 1;
+            c->a = _a;
+            c->capacity = _blockSize;
+            try {
+                c->data = c->a.allocate(_blockSize);}
+            catch (...) {
+                delete c;
+                throw;}
+            const size_type i = at ? at - 1 : 0;
+            try {
+                c->a.construct(c->data + i, v);}
+            catch (...) {
+                c->a.deallocate(c->data, _blockSize);
+                delete c;
+                throw;}
+            c->lo = i;
+            c->hi = i + 1;
+            Slice s = {c, i, i + 1};
+            return s;}
+
+        /**
+         * Gives up the elements of s's chunk past s.e when the chunk is held
+         * only by s and by the one slice it was copied from, so that neither
+         * sees them; a push after a pop then extends the chunk in place
+         * instead of starting a new one.
+         * @param s a slice of the version being pushed onto, a copy of the
+         *        version it was made from
+         */
+        static void reclaim_back (const Slice& s) {
+            Chunk* const c = s.c;
+            if (!c || (c->refs != 2))
+                return;
+            for (size_type i = s.e; i != c->hi; ++i)
+                c->a.destroy(c->data + i);
+            c->hi = s.e;}
+
+        static void reclaim_front (const Slice& s) {
+            Chunk* const c = s.c;
+            if (!c || (c->refs != 2))
+                return;
+            for (size_type i = c->lo; i != s.b; ++i)
+                c->a.destroy(c->data + i);
+            c->lo = s.b;}
+
+        static bool extends_back (const Slice& s) {
+            return s.c && (s.e == s.c->hi) && (s.c->hi != s.c->capacity);}
+
+        static bool extends_front (const Slice& s) {
+            return s.c && (s.b == s.c->lo) && (s.c->lo != 0);}
+
+        // -----
+        // nodes
+        // -----
+
+        static size_type height (const Node* t) {
+            return t ? t->height : 0;}
+
+        static size_type size (const Node* t) {
+            return t ? t->size : 0;}
+
+        static Node* retain (Node* t) {
+            if (t)
+                ++t->refs;
+            return t;}
+
+        static void release (Node* t) {
+            if (t && !--t->refs) {
+                release(t->left);
+                release(t->right);
+                release(t->s.c);
+                delete t;}}
+
+        // The tree functions below borrow their arguments and return a
+        // new reference that the caller owns.
+
+        static Node* create (Node* l, const Slice& s, Node* r) {
+            Node* t = new Node;
+            t->refs = 1;
+            t->height = std::max(height(l), height(r)) + 1;
+            t->size = size(l) + length(s) + size(r);
+            t->left = retain(l);
+            t->right = retain(r);
+            t->s = s;
+            retain(s.c);
+            return t;}
+
+        /**
+         * create() that restores balance when the heights of l and r differ
+         * by at most three
+         */
+        static Node* balance (Node* l, const Slice& s, Node* r) {
+            const size_type hl = height(l);
+            const size_type hr = height(r);
+            if (hl > hr + 2) {
+                if (height(l->left) >= height(l->right)) {
+                    Node* t = create(l->right, s, r);
+                    Node* x = create(l->left, l->s, t);
+                    release(t);
+                    return x;}
+                Node* lr = l->right;
+                Node* t1 = create(l->left, l->s, lr->left);
+                Node* t2 = create(lr->right, s, r);
+                Node* x = create(t1, lr->s, t2);
+                release(t1);
+                release(t2);
+                return x;}
+            if (hr > hl + 2) {
+                if (height(r->right) >= height(r->left)) {
+                    Node* t = create(l, s, r->left);
+                    Node* x = create(t, r->s, r->right);
+                    release(t);
+                    return x;}
+                Node* rl = r->left;
+                Node* t1 = create(l, s, rl->left);
+                Node* t2 = create(rl->right, r->s, r->right);
+                Node* x = create(t1, rl->s, t2);
+                release(t1);
+                release(t2);
+                return x;}
+            return create(l, s, r);}
+
+        static Node* add_min (const Slice& s, Node* t) {
+            if (!t)
+                return create(0, s, 0);
+            Node* l = add_min(s, t->left);
+            Node* x = balance(l, t->s, t->right);
+            release(l);
+            return x;}
+
+        static Node* add_max (const Slice& s, Node* t) {
+            if (!t)
+                return create(0, s, 0);
+            Node* r = add_max(s, t->right);
+            Node* x = balance(t->left, t->s, r);
+            release(r);
+            return x;}
+
+        /**
+         * @return a tree holding l, then s, then r
+         */
+        static Node* join (Node* l, const Slice& s, Node* r) {
+            if (!l)
+                return add_min(s, r);
+            if (!r)
+                return add_max(s, l);
+            if (l->height > r->height + 2) {
+                Node* t = join(l->right, s, r);
+                Node* x = balance(l->left, l->s, t);
+                release(t);
+                return x;}
+            if (r->height > l->height + 2) {
+                Node* t = join(l, s, r->left);
+                Node* x = balance(t, r->s, r->right);
+                release(t);
+                return x;}
+            return create(l, s, r);}
+
+        static const Slice& min_slice (const Node* t) {
+            while (t->left)
+                t = t->left;
+            return t->s;}
+
+        static const Slice& max_slice (const Node* t) {
+            while (t->right)
+                t = t->right;
+            return t->s;}
+
+        static Node* remove_min (Node* t) {
+            if (!t->left)
+                return retain(t->right);
+            Node* l = remove_min(t->left);
+            Node* x = balance(l, t->s, t->right);
+            release(l);
+            return x;}
+
+        static Node* remove_max (Node* t) {
+            if (!t->right)
+                return retain(t->left);
+            Node* r = remove_max(t->right);
+            Node* x = balance(t->left, t->s, r);
+            release(r);
+            return x;}
+
+        static Node* concat (Node* l, Node* r) {
+            if (!l)
+                return retain(r);
+            if (!r)
+                return retain(l);
+            Node* t = remove_min(r);
+            Node* x = join(l, min_slice(r), t);
+            release(t);
+            return x;}
+
+        /**
+         * splits t so that its first i elements end up in l and the rest in r,
+         * splitting a slice (but not its chunk) when i falls inside it
+         */
+        static void split (Node* t, size_type i, Node*& l, Node*& r) {
+            if (!t) {
+                l = r = 0;
+                return;}
+            const size_type sl = size(t->left);
+            const size_type n  = length(t->s);
+            if (i <= sl) {
+                Node* ll;
+                Node* lr;
+                split(t->left, i, ll, lr);
+                l = ll;
+                if (i == sl)
+                    r = add_min(t->s, t->right);
+                else
+                    r = join(lr, t->s, t->right);
+                release(lr);}
+            else if (i < sl + n) {
+                Slice s1 = t->s;
+                Slice s2 = t->s;
+                s1.e = s2.b = t->s.b + (i - sl);
+                l = add_max(s1, t->left);
+                r = add_min(s2, t->right);}
+            else {
+                Node* rl;
+                Node* rr;
+                split(t->right, i - sl - n, rl, rr);
+                l = join(t->left, t->s, rl);
+                r = rr;
+                release(rl);}}
+
+        static const_reference index (const Node* t, size_type i) {
+            for (;;) {
+                const size_type sl = size(t->left);
+                if (i < sl)
+                    t = t->left;
+                else if (i < sl + length(t->s))
+                    return t->s.c->data[t->s.b + (i - sl)];
+                else {
+                    i -= sl + length(t->s);
+                    t = t->right;}}}
+
+        // -------
+        // helpers
+        // -------
+
+        /**
+         * @return the whole version as a single tree, including the end slices
+         */
+        Node* flatten () const {
+            Node* t = _front.c ? add_min(_front, _tree) : retain(_tree);
+            if (!_back.c)
+                return t;
+            Node* x = add_max(_back, t);
+            release(t);
+            return x;}
+
+        /**
+         * Replaces the front slice, releasing the old chunk reference; s is
+         * adopted, not retained.
+         */
+        void set_front (const Slice& s) {
+            release(_front.c);
+            _front = s;}
+
+        void set_back (const Slice& s) {
+            release(_back.c);
+            _back = s;}
+
+        void set_tree (Node* t) {
+            release(_tree);
+            _tree = t;}
+
+        PersistentDeque (size_type blockSize, const allocator_type& a, Node* t) : _a(a), _blockSize(blockSize), _size(size(t)), _front(empty_slice()), _tree(t), _back(empty_slice()) {
+            assert(valid());}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * @param blockSize the number of elements in each chunk
+         * @param a the allocator to use for the chunks
+         */
+        explicit PersistentDeque (size_type blockSize = 64, const allocator_type& a = allocator_type()) : _a(a), _blockSize(blockSize), _size(0), _front(empty_slice()), _tree(0), _back(empty_slice()) {
+            assert(valid());}
+
+        /**
+         * O(1): shares all of that's structure
+         */
+        PersistentDeque (const PersistentDeque& that) : _a(that._a), _blockSize(that._blockSize), _size(that._size), _front(that._front), _tree(retain(that._tree)), _back(that._back) {
+            retain(_front.c);
+            retain(_back.c);
+            assert(valid());}
+
+        // ----------
+        // destructor
+        // ----------
+
+        /**
+         * Drops this version's references; chunks and nodes no other version uses are freed.
+         */
+        ~PersistentDeque () {
+            release(_front.c);
+            release(_tree);
+            release(_back.c);}
+
+        // ----------
+        // operator =
+        // ----------
+
+        /**
+         * @param that a PersistentDeque to be assigned
+         * @return a reference to this PersistentDeque, which now shares that's structure
+         */
+        PersistentDeque& operator = (const PersistentDeque& that) {
+            PersistentDeque x(that);
+            swap(x);
+            return *this;}
+
+        // -----------
+        // operator []
+        // -----------
+
+        /**
+         * @param i the index in the deque to retrieve
+         * @return read-only reference to the ith value in the deque
+         */
+        const_reference operator [] (size_type i) const {
+            const size_type nf = length(_front);
+            if (i < nf)
+                return _front.c->data[_front.b + i];
+            i -= nf;
+            if (i < size(_tree))
+                return index(_tree, i);
+            return _back.c->data[_back.b + (i - size(_tree))];}
+
+        // --
+        // at
+        // --
+
+        /**
+         * @param i the index in the deque to retrieve
+         * @return read-only reference to the ith value in the deque
+         * @throw out_of_range exception if the requested index does not exist
+         */
+        const_reference at (size_type i) const {
+            if (i >= _size)
+                throw std::out_of_range("PersistentDeque::at(index)");
+            return (*this)[i];}
+
+        // -----------
+        // front, back
+        // -----------
+
+        /**
+         * @return read-only reference to the first element
+         */
+        const_reference front () const {
+            assert(!empty());
+            return (*this)[0];}
+
+        /**
+         * @return read-only reference to the last element
+         */
+        const_reference back () const {
+            assert(!empty());
+            return (*this)[_size - 1];}
+
+        // ----------
+        // block_size
+        // ----------
+
+        /**
+         * @return the number of elements in each chunk
+         */
+        size_type block_size () const {
+            return _blockSize;}
+
+        // -----
+        // empty
+        // -----
+
+        /**
+         * @return True if there are no elements in the deque
+         */
+        bool empty () const {
+            return !size();}
+
+        // ----
+        // size
+        // ----
+
+        /**
+         * @return the number of elements in this version
+         */
+        size_type size () const {
+            return _size;}
+
+        // ----
+        // push
+        // ----
+
+        /**
+         * @param v the value to append
+         * @return a new version with v after the last element
+         */
+        PersistentDeque push_back (const_reference v) const {
+            PersistentDeque x(*this);
+            reclaim_back(!x._back.c && !x._tree ? x._front : x._back);
+            if (!x._back.c && !x._tree && extends_back(x._front)) {
+                x._a.construct(x._front.c->data + x._front.e, v);
+                x._front.c->hi = ++x._front.e;}
+            else if (extends_back(x._back)) {
+                x._a.construct(x._back.c->data + x._back.e, v);
+                x._back.c->hi = ++x._back.e;}
+            else {
+                const Slice s = make_slice(v, 0);
+                if (x._back.c) {
+                    x.set_tree(add_max(x._back, x._tree));
+                    x.set_back(empty_slice());}
+                x._back = s;}
+            ++x._size;
+            assert(x.valid());
+            return x;}
+
+        /**
+         * @param v the value to prepend
+         * @return a new version with v before the first element
+         */
+        PersistentDeque push_front (const_reference v) const {
+            PersistentDeque x(*this);
+            reclaim_front(!x._front.c && !x._tree ? x._back : x._front);
+            if (!x._front.c && !x._tree && extends_front(x._back)) {
+                x._a.construct(x._back.c->data + x._back.b - 1, v);
+                x._back.c->lo = --x._back.b;}
+            else if (extends_front(x._front)) {
+                x._a.construct(x._front.c->data + x._front.b - 1, v);
+                x._front.c->lo = --x._front.b;}
+            else {
+                const Slice s = make_slice(v, _blockSize);
+                if (x._front.c) {
+                    x.set_tree(add_min(x._front, x._tree));
+                    x.set_front(empty_slice());}
+                x._front = s;}
+            ++x._size;
+            assert(x.valid());
+            return x;}
+
+        // ---
+        // pop
+        // ---
+
+        /**
+         * @return a new version without the first element
+         */
+        PersistentDeque pop_front () const {
+            assert(!empty());
+            PersistentDeque x(*this);
+            if (!x._front.c && x._tree) {
+                x._front = min_slice(x._tree);
+                retain(x._front.c);
+                x.set_tree(remove_min(x._tree));}
+            Slice& s = x._front.c ? x._front : x._back;
+            if (++s.b == s.e) {
+                release(s.c);
+                s = empty_slice();}
+            --x._size;
+            assert(x.valid());
+            return x;}
+
+        /**
+         * @return a new version without the last element
+         */
+        PersistentDeque pop_back () const {
+            assert(!empty());
+            PersistentDeque x(*this);
+            if (!x._back.c && x._tree) {
+                x._back = max_slice(x._tree);
+                retain(x._back.c);
+                x.set_tree(remove_max(x._tree));}
+            Slice& s = x._back.c ? x._back : x._front;
+            if (--s.e == s.b) {
+                release(s.c);
+                s = empty_slice();}
+            --x._size;
+            assert(x.valid());
+            return x;}
+
+        // ------
+        // concat
+        // ------
+
+        /**
+         * O(log n)
+         * @param that the version to append
+         * @return a new version holding this version's elements followed by that's
+         */
+        PersistentDeque concat (const PersistentDeque& that) const {
+            if (that.empty())
+                return *this;
+            if (empty())
+                return that;
+            Node* l = _back.c ? add_max(_back, _tree) : retain(_tree);
+            Node* r = that._front.c ? add_min(that._front, that._tree) : retain(that._tree);
+            PersistentDeque x(*this);
+            x.set_tree(concat(l, r));
+            x.set_back(that._back);
+            retain(x._back.c);
+            x._size = _size + that._size;
+            release(l);
+            release(r);
+            assert(x.valid());
+            return x;}
+
+        // --------
+        // split_at
+        // --------
+
+        /**
+         * O(log n); the chunk straddling i is shared, not copied
+         * @param i the number of elements that go into the first version
+         * @return the first i elements and the remaining ones as two new versions
+         */
+        std::pair<PersistentDeque, PersistentDeque> split_at (size_type i) const {
+            if (i > _size)
+                throw std::out_of_range("PersistentDeque::split_at(index)");
+            Node* t = flatten();
+            Node* l;
+            Node* r;
+            split(t, i, l, r);
+            release(t);
+            return std::make_pair(PersistentDeque(_blockSize, _a, l), PersistentDeque(_blockSize, _a, r));}
+
+        // ----
+        // swap
+        // ----
+
+        /**
+         * swaps two versions in O(1)
+         */
+        void swap (PersistentDeque& that) {
+            std::swap(_a, that._a);
+            std::swap(_blockSize, that._blockSize);
+            std::swap(_size, that._size);
+            std::swap(_front, that._front);
+            std::swap(_tree, that._tree);
+            std::swap(_back, that._back);}};
+
+#endif // PersistentDeque_h
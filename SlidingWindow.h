@@ -0,0 +1,232 @@
+// -----------------------------
+// projects/deque/SlidingWindow.h
+// Copyright (C) 2012
+// Glenn P. Downing
+// -----------------------------
+
+#ifndef SlidingWindow_h
+#define SlidingWindow_h
+
+// --------
+// includes
+// --------
+
+#include <cassert> // assert
+#include <functional> // plus
+#include <memory> // allocator
+
+#include "Deque.h"
+
+// -------------
+// SlidingWindow
+// -------------
+
+/**
+ * A FIFO window of samples that answers min(), max() and aggregate() in
+ * O(1) after each push_back or pop_front, with O(1) amortized updates.
+ * min and max come from monotonic MyDeques of candidates. aggregate folds
+ * the window with an associative F, oldest sample on the left, using two
+ * stacks: the older part of the window keeps the fold of every suffix, the
+ * newer part keeps one running fold, and the older part is rebuilt from
+ * the newer one when it runs out.
+ */
+template < typename T, typename F = std::plus<T>, typename A = std::allocator<T> >
+class SlidingWindow {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef MyDeque<T, A> container_type;
+
+        typedef typename container_type::allocator_type allocator_type;
+        typedef typename container_type::value_type value_type;
+        typedef typename container_type::size_type size_type;
+        typedef typename container_type::const_reference const_reference;
+
+        typedef F function_type;
+
+    private:
+        // ----
+        // data
+        // ----
+
+        F _f;
+
+        container_type _window;
+
+        // _front[_front.size() - 1 - i] is the fold of _window[i, _front.size())
+        container_type _front;
+
+        // the fold of _window[_front.size(), _window.size()), if that is not empty
+        value_type _back;
+
+        // nondecreasing and nonincreasing candidates for min() and max()
+        container_type _min;
+        container_type _max;
+
+    private:
+        // -----
+        // valid
+        // -----
+
+        bool valid () const {
+            return (_front.size() <= _window.size()) &&
+                   (_min.size() <= _window.size()) &&
+                   (_max.size() <= _window.size()) &&
+                   (_window.empty() == _min.empty()) &&
+                   (_window.empty() == _max.empty());}
+
+        static bool equivalent (const_reference x, const_reference y) {
+            return !(x < y) && !(y < x);}
+
+        /**
+	 * moves every sample of the newer part into the older part
+	 */
+        void flip () {
+            assert(_front.empty());
+            const size_type n = _window.size();
+            if (!n)
+                return;
+            value_type x = _window[n - 1];
+            _front.push_back(x);
+            for (size_type i = n - 1; i != 0; --i) {
+                x = _f(_window[i - 1], x);
+                _front.push_back(x);}}
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+	 * @param f the associative function that aggregate() folds with
+	 * @param a the allocator to use
+	 */
+        explicit SlidingWindow (const F& f = F(), const allocator_type& a = allocator_type()) : _f(f), _window(a), _front(a), _back(), _min(a), _max(a) {
+            assert(valid());}
+
+        // Default copy, destructor, and copy assignment.
+        // SlidingWindow (const SlidingWindow&);
+        // ~SlidingWindow ();
+        // SlidingWindow& operator = (const SlidingWindow&);
+
+        // ---------
+        // aggregate
+        // ---------
+
+        /**
+	 * @return the fold of the window with F, oldest sample first; the window must not be empty
+	 */
+        value_type aggregate () const {
+            assert(!empty());
+            if (_front.empty())
+                return _back;
+            if (_front.size() == _window.size())
+                return _front.back();
+            return _f(_front.back(), _back);}
+
+        // -----------
+        // front, back
+        // -----------
+
+        /**
+	 * @return the oldest sample
+	 */
+        const_reference front () const {
+            return _window.front();}
+
+        /**
+	 * @return the newest sample
+	 */
+        const_reference back () const {
+            return _window.back();}
+
+        // -----
+        // empty
+        // -----
+
+        /**
+	 * @return True if there are no samples in the window
+	 */
+        bool empty () const {
+            return _window.empty();}
+
+        // --------
+        // min, max
+        // --------
+
+        /**
+	 * @return the smallest sample; the window must not be empty
+	 */
+        const_reference min () const {
+            assert(!empty());
+            return _min.front();}
+
+        /**
+	 * @return the largest sample; the window must not be empty
+	 */
+        const_reference max () const {
+            assert(!empty());
+            return _max.front();}
+
+        // ---------
+        // pop_front
+        // ---------
+
+        /**
+	 * removes the oldest sample
+	 */
+        void pop_front () {
+            assert(!empty());
+            if (_front.empty())
+                flip();
+            const_reference x = _window.front();
+            if (equivalent(_min.front(), x))
+                _min.pop_front();
+            if (equivalent(_max.front(), x))
+                _max.pop_front();
+            _front.pop_back();
+            _window.pop_front();
+            assert(valid());}
+
+        // ---------
+        // push_back
+        // ---------
+
+        /**
+	 * adds v as the newest sample
+	 * @param v const_reference of the sample to be added
+	 */
+        void push_back (const_reference v) {
+            _back = (_front.size() == _window.size()) ? v : _f(_back, v);
+            _window.push_back(v);
+            while (!_min.empty() && (v < _min.back()))
+                _min.pop_back();
+            _min.push_back(v);
+            while (!_max.empty() && (_max.back() < v))
+                _max.pop_back();
+            _max.push_back(v);
+            assert(valid());}
+
+        // ----
+        // size
+        // ----
+
+        /**
+	 * @return the number of samples in the window
+	 */
+        size_type size () const {
+            return _window.size();}
+
+        // ------
+        // window
+        // ------
+
+        /**
+	 * @return the samples, oldest first
+	 */
+        const container_type& window () const {
+            return _window;}};
+
+#endif // SlidingWindow_h
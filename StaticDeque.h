@@ -0,0 +1,774 @@
+// ----------------------------
+// projects/deque/StaticDeque.h
+// Copyright (C) 2012
+// Glenn P. Downing
+// ----------------------------
+
+#ifndef StaticDeque_h
+#define StaticDeque_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // equal, lexicographical_compare, swap
+#include <cassert> // assert
+#include <cstddef> // ptrdiff_t, size_t
+#include <iterator> // bidirectional_iterator_tag
+#include <new> // placement new
+#include <stdexcept> // length_error, out_of_range
+#include <utility> // !=, <=, >, >=
+
+// ---------------
+// overflow_policy
+// ---------------
+
+/**
+ * what a StaticDeque does when an element is added while it is full
+ */
+enum overflow_policy {
+    throw_on_overflow,      // throw length_error, leaving the deque alone
+    reject_on_overflow,     // return false, leaving the deque alone
+    overwrite_on_overflow}; // drop the element at the other end to make room
+
+// -----------------
+// next_power_of_two
+// -----------------
+
+/**
+ * value is the smallest power of two that is at least N
+ */
+template <std::size_t N, std::size_t P = 1, bool Done = (P >= N)>
+struct next_power_of_two {
+    enum {value = next_power_of_two<N, 2 * P>::value};};
+
+template <std::size_t N, std::size_t P>
+struct next_power_of_two<N, P, true> {
+    enum {value = P};};
+
+// -----------
+// StaticDeque
+// -----------
+
+/**
+ * A deque of at most N elements with MyDeque's interface that never
+ * allocates: the elements live in a ring buffer inside the object, whose
+ * size is rounded up to a power of two so that wrapping around is a mask
+ * instead of a division. P says what happens on overflow.
+ */
+template <typename T, std::size_t N, int P = throw_on_overflow>
+class StaticDeque {
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef T value_type;
+
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        typedef T* pointer;
+        typedef const T* const_pointer;
+
+        typedef T& reference;
+        typedef const T& const_reference;
+
+    public:
+        // -----------
+        // operator ==
+        // -----------
+
+        /**
+	 * @return true if lhs and rhs hold equal elements in the same order
+	 */
+        friend bool operator == (const StaticDeque& lhs, const StaticDeque& rhs) {
+            return (lhs.size() == rhs.size()) && std::equal(lhs.begin(), lhs.end(), rhs.begin());}
+
+        // ----------
+        // operator <
+        // ----------
+
+        /**
+	 * @return true if lhs is lexicographically less than rhs
+	 */
+        friend bool operator < (const StaticDeque& lhs, const StaticDeque& rhs) {
+            return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());}
+
+    private:
+        // ----
+        // ring
+        // ----
+
+        enum {ring = next_power_of_two<N>::value};
+
+        // -----
+        // slots
+        // -----
+
+        // raw, suitably aligned space for ring elements
+        union {
+            char _bytes[ring * sizeof(T)];
+            double _d;
+            long double _ld;
+            long _l;
+            void* _p;} _slots;
+
+        // index of the front element in the ring
+        size_type _b;
+        size_type _size;
+
+    private:
+        // -----
+        // valid
+        // -----
+
+        bool valid () const {
+            return (_b < size_type(ring)) && (_size <= N);}
+
+        // ----
+        // slot
+        // ----
+
+        /**
+	 * @return the address of the element at index, which may be one past the last
+	 */
+        pointer slot (size_type index) {
+            return reinterpret_cast<pointer>(_slots._bytes) + ((_b + index) & (ring - 1));}
+
+        const_pointer slot (size_type index) const {
+            return const_cast<StaticDeque*>(this)->slot(index);}
+
+        // --------
+        // overflow
+        // --------
+
+        /**
+	 * makes room for one element according to P
+	 * @param back true if the element is going on the back
+	 * @return false if the element must not be added
+	 * @throw length_error if P is throw_on_overflow
+	 */
+        bool overflow (bool back) {
+            assert(full());
+            if (P == throw_on_overflow)
+                throw std::length_error("StaticDeque: full");
+            if (P == reject_on_overflow || !N)
+                return false;
+            if (back)
+                pop_front();
+            else
+                pop_back();
+            return true;}
+
+    public:
+        class const_iterator;
+
+        // --------
+        // iterator
+        // --------
+
+        class iterator {
+            friend class const_iterator;
+
+            public:
+                // --------
+                // typedefs
+                // --------
+
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef typename StaticDeque::value_type value_type;
+                typedef typename StaticDeque::difference_type difference_type;
+                typedef typename StaticDeque::pointer pointer;
+                typedef typename StaticDeque::reference reference;
+
+            public:
+                // -----------
+                // operator ==
+                // -----------
+
+                /**
+		 * @return true if both iterators index the same element of the same StaticDeque
+		 */
+                friend bool operator == (const iterator& lhs, const iterator& rhs) {
+                    return (lhs._x == rhs._x) && (lhs._i == rhs._i);}
+
+                friend bool operator != (const iterator& lhs, const iterator& rhs) {
+                    return !(lhs == rhs);}
+
+                // ----------
+                // operator +
+                // ----------
+
+                friend iterator operator + (iterator lhs, difference_type rhs) {
+                    return lhs += rhs;}
+
+                // ----------
+                // operator -
+                // ----------
+
+                friend iterator operator - (iterator lhs, difference_type rhs) {
+                    return lhs -= rhs;}
+
+            private:
+                // ----
+                // data
+                // ----
+
+                StaticDeque* _x;
+                size_type _i;
+
+            public:
+                // -----------
+                // constructor
+                // -----------
+
+                /**
+		 * @param x the StaticDeque this iterator indexes
+		 * @param i the index of the element it points at
+		 */
+                iterator (StaticDeque* x, size_type i) : _x(x), _i(i) {}
+
+                // Default copy, destructor, and copy assignment.
+                // iterator (const iterator&);
+                // ~iterator ();
+                // iterator& operator = (const iterator&);
+
+                // -----
+                // index
+                // -----
+
+                /**
+		 * @return the index of the element this iterator points at
+		 */
+                size_type index () const {
+                    return _i;}
+
+                // ----------
+                // operator *
+                // ----------
+
+                reference operator * () const {
+                    return (*_x)[_i];}
+
+                // -----------
+                // operator ->
+                // -----------
+
+                pointer operator -> () const {
+                    return &**this;}
+
+                // -----------
+                // operator ++
+                // -----------
+
+                iterator& operator ++ () {
+                    ++_i;
+                    return *this;}
+
+                iterator operator ++ (int) {
+                    iterator x = *this;
+                    ++(*this);
+                    return x;}
+
+                // -----------
+                // operator --
+                // -----------
+
+                iterator& operator -- () {
+                    --_i;
+                    return *this;}
+
+                iterator operator -- (int) {
+                    iterator x = *this;
+                    --(*this);
+                    return x;}
+
+                // -----------
+                // operator +=
+                // -----------
+
+                iterator& operator += (difference_type d) {
+                    _i += d;
+                    return *this;}
+
+                // -----------
+                // operator -=
+                // -----------
+
+                iterator& operator -= (difference_type d) {
+                    _i -= d;
+                    return *this;}};
+
+    public:
+        // --------------
+        // const_iterator
+        // --------------
+
+        class const_iterator {
+            public:
+                // --------
+                // typedefs
+                // --------
+
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef typename StaticDeque::value_type value_type;
+                typedef typename StaticDeque::difference_type difference_type;
+                typedef typename StaticDeque::const_pointer pointer;
+                typedef typename StaticDeque::const_reference reference;
+
+            public:
+                // -----------
+                // operator ==
+                // -----------
+
+                /**
+		 * @return true if both iterators index the same element of the same StaticDeque
+		 */
+                friend bool operator == (const const_iterator& lhs, const const_iterator& rhs) {
+                    return (lhs._x == rhs._x) && (lhs._i == rhs._i);}
+
+                friend bool operator != (const const_iterator& lhs, const const_iterator& rhs) {
+                    return !(lhs == rhs);}
+
+                // ----------
+                // operator +
+                // ----------
+
+                friend const_iterator operator + (const_iterator lhs, difference_type rhs) {
+                    return lhs += rhs;}
+
+                // ----------
+                // operator -
+                // ----------
+
+                friend const_iterator operator - (const_iterator lhs, difference_type rhs) {
+                    return lhs -= rhs;}
+
+            private:
+                // ----
+                // data
+                // ----
+
+                const StaticDeque* _x;
+                size_type _i;
+
+            public:
+                // -----------
+                // constructor
+                // -----------
+
+                /**
+		 * @param x the StaticDeque this iterator indexes
+		 * @param i the index of the element it points at
+		 */
+                const_iterator (const StaticDeque* x, size_type i) : _x(x), _i(i) {}
+
+                /**
+		 * @param i the read/write iterator to read through
+		 */
+                const_iterator (const iterator& i) : _x(i._x), _i(i._i) {}
+
+                // Default copy, destructor, and copy assignment.
+                // const_iterator (const const_iterator&);
+                // ~const_iterator ();
+                // const_iterator& operator = (const const_iterator&);
+
+                // -----
+                // index
+                // -----
+
+                /**
+		 * @return the index of the element this iterator points at
+		 */
+                size_type index () const {
+                    return _i;}
+
+                // ----------
+                // operator *
+                // ----------
+
+                reference operator * () const {
+                    return (*_x)[_i];}
+
+                // -----------
+                // operator ->
+                // -----------
+
+                pointer operator -> () const {
+                    return &**this;}
+
+                // -----------
+                // operator ++
+                // -----------
+
+                const_iterator& operator ++ () {
+                    ++_i;
+                    return *this;}
+
+                const_iterator operator ++ (int) {
+                    const_iterator x = *this;
+                    ++(*this);
+                    return x;}
+
+                // -----------
+                // operator --
+                // -----------
+
+                const_iterator& operator -- () {
+                    --_i;
+                    return *this;}
+
+                const_iterator operator -- (int) {
+                    const_iterator x = *this;
+                    --(*this);
+                    return x;}
+
+                // -----------
+                // operator +=
+                // -----------
+
+                const_iterator& operator += (difference_type d) {
+                    _i += d;
+                    return *this;}
+
+                // -----------
+                // operator -=
+                // -----------
+
+                const_iterator& operator -= (difference_type d) {
+                    _i -= d;
+                    return *this;}};
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        StaticDeque () : _b(0), _size(0) {
+            assert(valid());}
+
+        /**
+	 * @param s the number of elements, at most N
+	 * @param v the value to copy into each
+	 * @throw length_error if s is more than N
+	 */
+        explicit StaticDeque (size_type s, const_reference v = value_type()) : _b(0), _size(0) {
+            if (s > N)
+                throw std::length_error("StaticDeque: size exceeds capacity");
+            resize(s, v);
+            assert(valid());}
+
+        StaticDeque (const StaticDeque& that) : _b(0), _size(0) {
+            try {
+                for (size_type i = 0; i != that._size; ++i)
+                    push_back(that[i]);}
+            catch (...) {
+                clear();
+                throw;}
+            assert(valid());}
+
+        // ----------
+        // destructor
+        // ----------
+
+        ~StaticDeque () {
+            clear();}
+
+        // ----------
+        // operator =
+        // ----------
+
+        /**
+	 * assigns over the elements both deques have, then constructs or destroys the rest
+	 */
+        StaticDeque& operator = (const StaticDeque& rhs) {
+            if (this == &rhs)
+                return *this;
+            const size_type n = std::min(_size, rhs._size);
+            for (size_type i = 0; i != n; ++i)
+                (*this)[i] = rhs[i];
+            while (_size > rhs._size)
+                pop_back();
+            while (_size < rhs._size)
+                push_back(rhs[_size]);
+            assert(valid());
+            return *this;}
+
+        // -----------
+        // operator []
+        // -----------
+
+        /**
+	 * @return the element at index, which must be less than size()
+	 */
+        reference operator [] (size_type index) {
+            assert(index < _size);
+            return *slot(index);}
+
+        const_reference operator [] (size_type index) const {
+            return const_cast<StaticDeque*>(this)->operator[](index);}
+
+        // --
+        // at
+        // --
+
+        /**
+	 * @return the element at index
+	 * @throw out_of_range if index is not less than size()
+	 */
+        reference at (size_type index) {
+            if (index >= _size)
+                throw std::out_of_range("StaticDeque::at index out of range");
+            return (*this)[index];}
+
+        const_reference at (size_type index) const {
+            return const_cast<StaticDeque*>(this)->at(index);}
+
+        // ----
+        // back
+        // ----
+
+        reference back () {
+            assert(!empty());
+            return (*this)[_size - 1];}
+
+        const_reference back () const {
+            return const_cast<StaticDeque*>(this)->back();}
+
+        // -----
+        // begin
+        // -----
+
+        iterator begin () {
+            return iterator(this, 0);}
+
+        const_iterator begin () const {
+            return const_iterator(this, 0);}
+
+        // --------
+        // capacity
+        // --------
+
+        /**
+	 * @return N, the most elements the deque holds
+	 */
+        size_type capacity () const {
+            return N;}
+
+        size_type max_size () const {
+            return N;}
+
+        // -----
+        // clear
+        // -----
+
+        void clear () {
+            while (_size)
+                pop_back();
+            _b = 0;}
+
+        // -----
+        // empty
+        // -----
+
+        bool empty () const {
+            return !_size;}
+
+        // ---
+        // end
+        // ---
+
+        iterator end () {
+            return iterator(this, _size);}
+
+        const_iterator end () const {
+            return const_iterator(this, _size);}
+
+        // -----
+        // erase
+        // -----
+
+        /**
+	 * removes the element at i, shifting the shorter side over it
+	 * @return an iterator to the element that followed it
+	 */
+        iterator erase (iterator i) {
+            const size_type k = i.index();
+            assert(k < _size);
+            if (k < _size - 1 - k) {
+                for (size_type j = k; j != 0; --j)
+                    (*this)[j] = (*this)[j - 1];
+                pop_front();}
+            else {
+                for (size_type j = k; j != _size - 1; ++j)
+                    (*this)[j] = (*this)[j + 1];
+                pop_back();}
+            assert(valid());
+            return iterator(this, k);}
+
+        // -----
+        // front
+        // -----
+
+        reference front () {
+            assert(!empty());
+            return (*this)[0];}
+
+        const_reference front () const {
+            return const_cast<StaticDeque*>(this)->front();}
+
+        // ----
+        // full
+        // ----
+
+        bool full () const {
+            return _size == N;}
+
+        // ------
+        // insert
+        // ------
+
+        /**
+	 * inserts v before i, shifting the shorter side to make room; when the
+	 * deque is full, P decides, and overwriting drops the front element
+	 * @return an iterator to the inserted element, or end() if it was rejected
+	 * @throw length_error if the deque is full and P is throw_on_overflow
+	 */
+        iterator insert (iterator i, const_reference v) {
+            size_type k = i.index();
+            assert(k <= _size);
+            const value_type x = v;
+            if (full()) {
+                if (!overflow(true))
+                    return end();
+                if (k)
+                    --k;}
+            if (!k)
+                push_front(x);
+            else if (k == _size)
+                push_back(x);
+            else if (k < _size - k) {
+                push_front(front());
+                for (size_type j = 1; j != k; ++j)
+                    (*this)[j] = (*this)[j + 1];
+                (*this)[k] = x;}
+            else {
+                push_back(back());
+                for (size_type j = _size - 2; j != k; --j)
+                    (*this)[j] = (*this)[j - 1];
+                (*this)[k] = x;}
+            assert(valid());
+            return iterator(this, k);}
+
+        // --------
+        // pop_back
+        // --------
+
+        void pop_back () {
+            assert(!empty());
+            slot(_size - 1)->~T();
+            --_size;
+            assert(valid());}
+
+        // ---------
+        // pop_front
+        // ---------
+
+        void pop_front () {
+            assert(!empty());
+            slot(0)->~T();
+            _b = (_b + 1) & (ring - 1);
+            --_size;
+            assert(valid());}
+
+        // ---------
+        // push_back
+        // ---------
+
+        /**
+	 * @param v the value to append
+	 * @return false if the deque is full and P is reject_on_overflow
+	 * @throw length_error if the deque is full and P is throw_on_overflow
+	 */
+        bool push_back (const_reference v) {
+            if (full()) {
+                const value_type x = v;
+                if (!overflow(true))
+                    return false;
+                new (slot(_size)) T(x);}
+            else
+                new (slot(_size)) T(v);
+            ++_size;
+            assert(valid());
+            return true;}
+
+        // ----------
+        // push_front
+        // ----------
+
+        /**
+	 * @param v the value to prepend
+	 * @return false if the deque is full and P is reject_on_overflow
+	 * @throw length_error if the deque is full and P is throw_on_overflow
+	 */
+        bool push_front (const_reference v) {
+            if (full()) {
+                const value_type x = v;
+                if (!overflow(false))
+                    return false;
+                return push_front(x);}
+            const size_type b = (_b - 1) & (ring - 1);
+            new (reinterpret_cast<pointer>(_slots._bytes) + b) T(v);
+            _b = b;
+            ++_size;
+            assert(valid());
+            return true;}
+
+        // ------
+        // resize
+        // ------
+
+        /**
+	 * @param s the new size, at most N
+	 * @param v the value to copy into new elements
+	 * @throw length_error if s is more than N
+	 */
+        void resize (size_type s, const_reference v = value_type()) {
+            if (s > N)
+                throw std::length_error("StaticDeque: size exceeds capacity");
+            while (_size > s)
+                pop_back();
+            while (_size < s)
+                push_back(v);
+            assert(valid());}
+
+        // ----
+        // size
+        // ----
+
+        size_type size () const {
+            return _size;}
+
+        // ----
+        // swap
+        // ----
+
+        /**
+	 * exchanges the elements of the two deques; unlike MyDeque's this is linear
+	 */
+        void swap (StaticDeque& that) {
+            StaticDeque* s = this;
+            StaticDeque* l = &that;
+            if (s->_size > l->_size)
+                std::swap(s, l);
+            for (size_type i = 0; i != s->_size; ++i)
+                std::swap((*s)[i], (*l)[i]);
+            const size_type n = s->_size;
+            for (size_type i = n; i != l->_size; ++i)
+                s->push_back((*l)[i]);
+            while (l->_size != n)
+                l->pop_back();
+            assert(valid());}};
+
+#endif // StaticDeque_h
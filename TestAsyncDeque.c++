@@ -0,0 +1,245 @@
+// ---------------------------------
+// projects/deque/TestAsyncDeque.c++
+// Copyright (C) 2012
+// Glenn P. Downing
+// ---------------------------------
+
+/*
+To test the program:
+% g++ -ansi -pedantic -lcppunit -ldl -lpthread -Wall TestAsyncDeque.c++ -o TestAsyncDeque.c++.app
+% valgrind TestAsyncDeque.c++.app >& TestAsyncDeque.out
+*/
+
+// --------
+// includes
+// --------
+
+#include <vector> // vector
+
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE_END
+#include "cppunit/TestFixture.h" // TestFixture
+#include "cppunit/TextTestRunner.h" // TestRunner
+
+#include "AsyncDeque.h"
+#include "Executor.h"
+
+// --------------
+// TestAsyncDeque
+// --------------
+
+struct TestAsyncDeque : CppUnit::TestFixture {
+    typedef AsyncDeque<int> Q;
+
+    // pushes 0, 1, ..., n - 1
+    struct Producer : Task {
+        Q& q;
+        int i;
+        int n;
+
+        Producer (Q& p, int m) : q(p), i(0), n(m) {}
+
+        void run () {
+            if (i != n)
+                q.push_back(i++, this);}};
+
+    // pops n values and sums them
+    struct Consumer : Task {
+        Q& q;
+        int v;
+        int n;
+        long sum;
+        bool started;
+
+        Consumer (Q& p, int m) : q(p), v(0), n(m), sum(0), started(false) {}
+
+        void run () {
+            if (started) {
+                sum += v;
+                --n;}
+            started = true;
+            if (n)
+                q.pop_front(v, this);}};
+
+    // pops n values from in and pushes each one plus one onto out
+    struct Relay : Task {
+        Q& in;
+        Q& out;
+        int v;
+        int n;
+        bool popped;
+
+        Relay (Q& p, Q& q, int m) : in(p), out(q), v(0), n(m), popped(false) {}
+
+        void run () {
+            if (popped) {
+                popped = false;
+                --n;
+                out.push_back(v + 1, this);}
+            else if (n) {
+                popped = true;
+                in.pop_front(v, this);}}};
+
+    // -------------
+    // try_push_back
+    // -------------
+
+    void test_try_1 () {
+        LoopExecutor x;
+        Q q(x, 2);
+        CPPUNIT_ASSERT(q.try_push_back(1));
+        CPPUNIT_ASSERT(q.try_push_back(2));
+        CPPUNIT_ASSERT(!q.try_push_back(3));
+        CPPUNIT_ASSERT(q.size() == 2);
+        int v = 0;
+        CPPUNIT_ASSERT(q.try_pop_front(v));
+        CPPUNIT_ASSERT(v == 1);
+        CPPUNIT_ASSERT(q.try_pop_front(v));
+        CPPUNIT_ASSERT(v == 2);
+        CPPUNIT_ASSERT(!q.try_pop_front(v));
+        CPPUNIT_ASSERT(v == 2);
+        CPPUNIT_ASSERT(x.empty());}
+
+    // ------------
+    // backpressure
+    // ------------
+
+    void test_backpressure_1 () {
+        LoopExecutor x;
+        Q q(x, 2);
+        Producer p(q, 10);
+        x.post(&p);
+        CPPUNIT_ASSERT(x.run() == 3);
+        CPPUNIT_ASSERT(q.size() == 2);
+        CPPUNIT_ASSERT(p.i == 3);
+        int v;
+        CPPUNIT_ASSERT(q.try_pop_front(v));
+        CPPUNIT_ASSERT(v == 0);
+        CPPUNIT_ASSERT(q.size() == 2);
+        CPPUNIT_ASSERT(x.run() == 1);
+        CPPUNIT_ASSERT(p.i == 4);}
+
+    void test_backpressure_2 () {
+        LoopExecutor x;
+        Q q(x, 0);
+        Producer p(q, 3);
+        Consumer c(q, 3);
+        x.post(&p);
+        x.run();
+        CPPUNIT_ASSERT(q.size() == 0);
+        x.post(&c);
+        x.run();
+        CPPUNIT_ASSERT(c.n == 0);
+        CPPUNIT_ASSERT(c.sum == 3);}
+
+    // --------
+    // pipeline
+    // --------
+
+    void test_pipeline_1 () {
+        LoopExecutor x;
+        Q q(x, 4);
+        Consumer c(q, 1000);
+        Producer p(q, 1000);
+        x.post(&c);
+        x.post(&p);
+        x.run();
+        CPPUNIT_ASSERT(c.n == 0);
+        CPPUNIT_ASSERT(c.sum == 499500);
+        CPPUNIT_ASSERT(q.empty());}
+
+    void test_pipeline_2 () {
+        const int stages = 1000;
+        const int n = 50;
+        LoopExecutor x;
+        std::vector<Q*> qs;
+        for (int i = 0; i != stages + 1; ++i)
+            qs.push_back(new Q(x, 1));
+        std::vector<Relay*> rs;
+        for (int i = 0; i != stages; ++i) {
+            rs.push_back(new Relay(*qs[i], *qs[i + 1], n));
+            x.post(rs.back());}
+        Producer p(*qs.front(), n);
+        Consumer c(*qs.back(), n);
+        x.post(&p);
+        x.post(&c);
+        x.run();
+        CPPUNIT_ASSERT(c.n == 0);
+        CPPUNIT_ASSERT(c.sum == n * (n - 1) / 2 + n * stages);
+        for (int i = 0; i != stages; ++i)
+            delete rs[i];
+        for (int i = 0; i != stages + 1; ++i)
+            delete qs[i];}
+
+    // ----------
+    // threadpool
+    // ----------
+
+    void test_threadpool_1 () {
+        const int stages = 100;
+        const int n = 200;
+        ThreadPoolExecutor x(4);
+        std::vector<Q*> qs;
+        for (int i = 0; i != stages + 1; ++i)
+            qs.push_back(new Q(x, 2));
+        std::vector<Relay*> rs;
+        for (int i = 0; i != stages; ++i)
+            rs.push_back(new Relay(*qs[i], *qs[i + 1], n));
+        Producer p(*qs.front(), n);
+        Consumer c(*qs.back(), n);
+        for (int i = 0; i != stages; ++i)
+            x.post(rs[i]);
+        x.post(&p);
+        x.post(&c);
+        x.wait();
+        CPPUNIT_ASSERT(c.n == 0);
+        CPPUNIT_ASSERT(c.sum == n * (n - 1) / 2 + n * stages);
+        for (int i = 0; i != stages; ++i)
+            delete rs[i];
+        for (int i = 0; i != stages + 1; ++i)
+            delete qs[i];}
+
+    void test_threadpool_2 () {
+        ThreadPoolExecutor x(3);
+        Q q(x, 8);
+        std::vector<Producer*> ps;
+        for (int i = 0; i != 4; ++i)
+            ps.push_back(new Producer(q, 1000));
+        Consumer c(q, 4000);
+        x.post(&c);
+        for (int i = 0; i != 4; ++i)
+            x.post(ps[i]);
+        x.wait();
+        CPPUNIT_ASSERT(c.n == 0);
+        CPPUNIT_ASSERT(c.sum == 4 * 499500);
+        for (int i = 0; i != 4; ++i)
+            delete ps[i];}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestAsyncDeque);
+    CPPUNIT_TEST(test_try_1);
+    CPPUNIT_TEST(test_backpressure_1);
+    CPPUNIT_TEST(test_backpressure_2);
+    CPPUNIT_TEST(test_pipeline_1);
+    CPPUNIT_TEST(test_pipeline_2);
+    CPPUNIT_TEST(test_threadpool_1);
+    CPPUNIT_TEST(test_threadpool_2);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ----
+// main
+// ----
+
+int main () {
+    using namespace std;
+    ios_base::sync_with_stdio(false); // turn off synchronization with C I/O
+    cout << "TestAsyncDeque.c++" << endl << endl;
+
+    CppUnit::TextTestRunner tr;
+    tr.addTest(TestAsyncDeque::suite());
+    tr.run();
+
+    cout << "Done." << endl;
+    return 0;}
@@ -0,0 +1,201 @@
+// -------------------------------------
+// projects/deque/TestBlockAllocator.c++
+// Copyright (C) 2012
+// Glenn P. Downing
+// -------------------------------------
+
+/*
+To test the program:
+% g++ -ansi -pedantic -lcppunit -ldl -Wall TestBlockAllocator.c++ -o TestBlockAllocator.c++.app
+% valgrind TestBlockAllocator.c++.app >& TestBlockAllocator.out
+*/
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // equal
+#include <cstddef> // size_t
+#include <deque> // deque
+#include <string> // string
+#include <vector> // vector
+
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE_END
+#include "cppunit/TestFixture.h" // TestFixture
+#include "cppunit/TextTestRunner.h" // TestRunner
+
+#include "BlockAllocator.h"
+#include "Deque.h"
+
+// ------------------
+// TestBlockAllocator
+// ------------------
+
+struct TestBlockAllocator : CppUnit::TestFixture {
+    static bool aligned (const void* p, std::size_t n) {
+        return !(reinterpret_cast<std::size_t>(p) % n);}
+
+    // --------
+    // allocate
+    // --------
+
+    void test_allocate_1 () {
+        BlockAllocator<char> a;
+        for (int n = 1; n != 200; ++n) {
+            char* p = a.allocate(n);
+            CPPUNIT_ASSERT(aligned(p, 64));
+            p[0] = 'a';
+            p[n - 1] = 'b';
+            a.deallocate(p, n);}}
+
+    void test_allocate_2 () {
+        typedef BlockAllocator<double, transparent_huge_pages> A;
+        A a;
+        const std::size_t n = A::hugePageSize / sizeof(double) + 1;
+        double* p = a.allocate(n);
+        CPPUNIT_ASSERT(aligned(p, A::hugePageSize));
+        p[0] = 1;
+        p[n - 1] = 2;
+        CPPUNIT_ASSERT(p[0] + p[n - 1] == 3);
+        a.deallocate(p, n);}
+
+    void test_allocate_3 () {
+        typedef BlockAllocator<int, explicit_huge_pages> A;
+        A a;
+        const std::size_t n = A::hugePageSize / sizeof(int);
+        int* p = a.allocate(n);
+        CPPUNIT_ASSERT(aligned(p, A::hugePageSize));
+        p[n - 1] = 3;
+        CPPUNIT_ASSERT(p[n - 1] == 3);
+        a.deallocate(p, n);}
+
+    // ----
+    // pool
+    // ----
+
+    void test_pool_1 () {
+        typedef BlockAllocator<int, transparent_huge_pages> A;
+        A a;
+        std::vector<int*> v;
+        for (int i = 0; i != 2000; ++i) {
+            v.push_back(a.allocate(512));
+            CPPUNIT_ASSERT(aligned(v.back(), 512 * sizeof(int)));
+            v.back()[511] = i;}
+        for (int i = 0; i != 2000; ++i)
+            CPPUNIT_ASSERT(v[i][511] == i);
+        int* const p = v.back();
+        a.deallocate(p, 512);
+        CPPUNIT_ASSERT(a.allocate(500) == p);
+        v.pop_back();
+        a.deallocate(p, 500);
+        for (int i = 0; i != 2000 - 1; ++i)
+            a.deallocate(v[i], 512);
+        int* const q = a.allocate(1);
+        CPPUNIT_ASSERT(aligned(q, 64));
+        a.deallocate(q, 1);}
+
+    void test_pool_2 () {
+        typedef BlockAllocator<int, transparent_huge_pages> A;
+        MyDeque<int, A> x;
+        for (int i = 0; i != 100000; ++i)
+            x.push_back(i % 10);
+        for (int i = 0; i < 100000; i += 512)
+            CPPUNIT_ASSERT(aligned(&x[i] - (i + 512 / 3) % 512, 512 * sizeof(int)));
+        CPPUNIT_ASSERT(sum(x) == 450000);}
+
+    void test_pool_3 () {
+        typedef BlockAllocator<int, transparent_huge_pages> A;
+        typedef HugePagePool<transparent_huge_pages> P;
+        const int n = P::maxBlock / sizeof(int);
+        const std::size_t m = P::arena_count();
+        A a;
+        std::vector<int*> v;
+        for (int i = 0; i != 6; ++i)
+            v.push_back(a.allocate(n));
+        CPPUNIT_ASSERT(P::arena_count() >= m + 2);
+        for (int i = 0; i != 6; ++i)
+            a.deallocate(v[i], n);
+        CPPUNIT_ASSERT(P::arena_count() <= m + 1);
+        for (int j = 0; j != 100; ++j) {
+            int* const p = a.allocate(n);
+            a.deallocate(p, n);}
+        CPPUNIT_ASSERT(P::arena_count() <= m + 1);}
+
+    // ------
+    // rebind
+    // ------
+
+    void test_rebind_1 () {
+        typedef BlockAllocator<int, transparent_huge_pages> A;
+        A::rebind<int*>::other b = A();
+        A a(b);
+        CPPUNIT_ASSERT(a == A(b));
+        CPPUNIT_ASSERT(!(a != A(b)));
+        int** p = b.allocate(3);
+        CPPUNIT_ASSERT(aligned(p, 64));
+        b.deallocate(p, 3);}
+
+    // -------
+    // MyDeque
+    // -------
+
+    void test_deque_1 () {
+        MyDeque< std::string, BlockAllocator<std::string> > x;
+        std::deque<std::string> y;
+        for (int i = 0; i != 2000; ++i) {
+            const std::string s(i % 7 + 1, char('a' + i % 26));
+            if (i % 3) {
+                x.push_back(s);
+                y.push_back(s);}
+            else {
+                x.push_front(s);
+                y.push_front(s);}}
+        CPPUNIT_ASSERT(x.size() == y.size());
+        CPPUNIT_ASSERT(std::equal(x.begin(), x.end(), y.begin()));
+        for (int i = 0; i != 1500; ++i) {
+            x.pop_front();
+            y.pop_front();}
+        CPPUNIT_ASSERT(std::equal(x.begin(), x.end(), y.begin()));}
+
+    void test_deque_2 () {
+        typedef BlockAllocator<int, transparent_huge_pages> A;
+        const int n = A::hugePageSize / sizeof(int);
+        MyDeque<int, A> x(n, 1);
+        CPPUNIT_ASSERT(aligned(&x[0], 64));
+        CPPUNIT_ASSERT(sum(x) == n);
+        x.resize(3 * n, 2);
+        CPPUNIT_ASSERT(sum(x) == 5 * n);
+        const MyDeque<int, A> y(x);
+        CPPUNIT_ASSERT(x == y);}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestBlockAllocator);
+    CPPUNIT_TEST(test_allocate_1);
+    CPPUNIT_TEST(test_allocate_2);
+    CPPUNIT_TEST(test_allocate_3);
+    CPPUNIT_TEST(test_pool_1);
+    CPPUNIT_TEST(test_pool_2);
+    CPPUNIT_TEST(test_pool_3);
+    CPPUNIT_TEST(test_rebind_1);
+    CPPUNIT_TEST(test_deque_1);
+    CPPUNIT_TEST(test_deque_2);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ----
+// main
+// ----
+
+int main () {
+    using namespace std;
+    ios_base::sync_with_stdio(false); // turn off synchronization with C I/O
+    cout << "TestBlockAllocator.c++" << endl << endl;
+
+    CppUnit::TextTestRunner tr;
+    tr.addTest(TestBlockAllocator::suite());
+    tr.run();
+
+    cout << "Done." << endl;
+    return 0;}
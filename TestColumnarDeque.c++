@@ -0,0 +1,177 @@
+// ------------------------------------
+// projects/deque/TestColumnarDeque.c++
+// Copyright (C) 2012
+// Glenn P. Downing
+// ------------------------------------
+
+/*
+To test the program:
+% g++ -ansi -pedantic -lcppunit -ldl -Wall TestColumnarDeque.c++ -o TestColumnarDeque.c++.app
+% valgrind TestColumnarDeque.c++.app >& TestColumnarDeque.out
+*/
+
+// --------
+// includes
+// --------
+
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE_END
+#include "cppunit/TestFixture.h" // TestFixture
+#include "cppunit/TextTestRunner.h" // TestRunner
+
+#include "ColumnarDeque.h"
+
+// -----------------
+// TestColumnarDeque
+// -----------------
+
+struct TestColumnarDeque : CppUnit::TestFixture {
+    typedef ColumnarDeque<int, double, float> C;
+    typedef C::value_type R;
+
+    // ------------
+    // constructors
+    // ------------
+
+    void test_constructor_1 () {
+        const C x;
+        CPPUNIT_ASSERT(x.empty());}
+
+    void test_constructor_2 () {
+        const C x(10, R(1, 2.0, 3.0f));
+        CPPUNIT_ASSERT(x.size() == 10);
+        CPPUNIT_ASSERT(x[9] == R(1, 2.0, 3.0f));}
+
+    // ----
+    // push
+    // ----
+
+    void test_push_back_1 () {
+        C x;
+        for (int i = 0; i != 1000; ++i)
+            x.push_back(R(i, i / 2.0, -i));
+        CPPUNIT_ASSERT(x.size() == 1000);
+        CPPUNIT_ASSERT(x[500] == R(500, 250.0, -500.0f));
+        CPPUNIT_ASSERT(R(x.back()) == R(999, 499.5, -999.0f));}
+
+    void test_push_front_1 () {
+        C x;
+        for (int i = 0; i != 1000; ++i)
+            x.push_front(R(i));
+        CPPUNIT_ASSERT(x.front().get<0>() == 999);
+        CPPUNIT_ASSERT(x.back().get<0>() == 0);
+        CPPUNIT_ASSERT(x.back().get<1>() == 0.0);}
+
+    // ---
+    // pop
+    // ---
+
+    void test_pop_1 () {
+        C x;
+        for (int i = 0; i != 1000; ++i)
+            x.push_back(R(i, i, i));
+        for (int i = 0; i != 600; ++i)
+            x.pop_front();
+        for (int i = 0; i != 100; ++i)
+            x.pop_back();
+        CPPUNIT_ASSERT(x.size() == 300);
+        CPPUNIT_ASSERT(x[0] == R(600, 600, 600));
+        CPPUNIT_ASSERT(x[299] == R(899, 899, 899));}
+
+    // ---------
+    // reference
+    // ---------
+
+    void test_reference_1 () {
+        C x(3);
+        x[1] = R(7, 8.5, 9.0f);
+        x[2].get<1>() = 4.5;
+        x[0] = x[1];
+        CPPUNIT_ASSERT(x[0] == R(7, 8.5, 9.0f));
+        CPPUNIT_ASSERT(x[2] == R(0, 4.5, 0.0f));}
+
+    void test_reference_2 () {
+        typedef ColumnarDeque<int, bool> D;
+        typedef D::value_type S;
+        D x;
+        for (int i = 0; i != 1000; ++i)
+            x.push_back(S(i, i % 3 == 0));
+        const D& y = x;
+        CPPUNIT_ASSERT(y[3] == S(3, true));
+        CPPUNIT_ASSERT(y[4] == S(4, false));
+        CPPUNIT_ASSERT(x[999].get<1>());
+        x[4].get<1>() = true;
+        x[3].get<1>() = false;
+        CPPUNIT_ASSERT(y[4] == S(4, true));
+        CPPUNIT_ASSERT(y[3] == S(3, false));
+        x[5] = S(-5, true);
+        CPPUNIT_ASSERT(S(x[5]) == S(-5, true));
+        CPPUNIT_ASSERT(y.column<1>().count() == 335);}
+
+    // ------
+    // column
+    // ------
+
+    void test_column_1 () {
+        C x;
+        for (int i = 0; i != 1000; ++i)
+            x.push_back(R(i, 1.0, 2.0f));
+        const C& y = x;
+        CPPUNIT_ASSERT(sum(y.column<0>()) == 499500);
+        CPPUNIT_ASSERT(sum(y.column<1>()) == 1000.0);
+        CPPUNIT_ASSERT(count(y.column<2>(), 2.0f) == 1000);}
+
+    void test_column_2 () {
+        C x;
+        for (int i = 0; i != 1000; ++i)
+            x.push_back(R(i, i, i));
+        MyDeque<int>::size_type n0;
+        MyDeque<double>::size_type n1;
+        const int* p = x.column<0>().segment(0, n0);
+        const double* q = x.column<1>().segment(0, n1);
+        CPPUNIT_ASSERT(n0 == n1);
+        CPPUNIT_ASSERT(p[n0 - 1] == int(n0 - 1));
+        CPPUNIT_ASSERT(q[n1 - 1] == double(n1 - 1));}
+
+    // -----
+    // clear
+    // -----
+
+    void test_clear_1 () {
+        C x(5);
+        x.clear();
+        CPPUNIT_ASSERT(x.empty());
+        x.push_back(R(1));
+        CPPUNIT_ASSERT(x.size() == 1);}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestColumnarDeque);
+    CPPUNIT_TEST(test_constructor_1);
+    CPPUNIT_TEST(test_constructor_2);
+    CPPUNIT_TEST(test_push_back_1);
+    CPPUNIT_TEST(test_push_front_1);
+    CPPUNIT_TEST(test_pop_1);
+    CPPUNIT_TEST(test_reference_1);
+    CPPUNIT_TEST(test_reference_2);
+    CPPUNIT_TEST(test_column_1);
+    CPPUNIT_TEST(test_column_2);
+    CPPUNIT_TEST(test_clear_1);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ----
+// main
+// ----
+
+int main () {
+    using namespace std;
+    ios_base::sync_with_stdio(false); // turn off synchronization with C I/O
+    cout << "TestColumnarDeque.c++" << endl << endl;
+
+    CppUnit::TextTestRunner tr;
+    tr.addTest(TestColumnarDeque::suite());
+    tr.run();
+
+    cout << "Done." << endl;
+    return 0;}
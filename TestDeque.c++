@@ -20,12 +20,16 @@ HelperMacros.h
 // includes
 // --------
 
-#include <algorithm> // equal
+#include <algorithm> // count, equal, min
+#include <cstdlib> // rand, srand
 #include <cstring> // strcmp
 #include <deque> // deque
+#include <iterator> // back_inserter
+#include <limits> // numeric_limits
 #include <sstream> // ostringstream
 #include <stdexcept> // invalid_argument
 #include <string> // ==
+#include <vector> // vector
 
 #include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE_END
 #include "cppunit/TestFixture.h" // TestFixture
@@ -707,6 +711,966 @@ struct TestDeque : CppUnit::TestFixture {
 
   
 
+    CPPUNIT_TEST_SUITE_END();};
+
+// -------------------------
+// TestDeque< MyDeque<bool> >
+// -------------------------
+
+// the generic tests that increment an element or take its address, which
+// MyDeque<bool>'s proxy references, like std::vector<bool>'s, do not allow,
+// and the one that compares an element with 10, which no flag can equal
+
+template <>
+void TestDeque< MyDeque<bool> >::test_at_3 () {
+    const MyDeque<bool> x(10, true);
+    CPPUNIT_ASSERT(x.at(5) == true);}
+
+template <>
+void TestDeque< MyDeque<bool> >::test_begin_2 () {
+    MyDeque<bool> a(10, false);
+    MyDeque<bool>::iterator iter = a.begin();
+    (*iter).flip();
+    CPPUNIT_ASSERT(*iter == true);
+    CPPUNIT_ASSERT(a[1] == false);}
+
+template <>
+void TestDeque< MyDeque<bool> >::test_push_front_6 () {
+    MyDeque<bool> a(1, true);
+    for (int i = 0; i != 5; ++i)
+        a.push_front(i % 2);
+    CPPUNIT_ASSERT(a.size() == 6);
+    CPPUNIT_ASSERT(a.back() == true);
+    CPPUNIT_ASSERT(a[0] == false);
+    CPPUNIT_ASSERT(a[1] == true);}
+
+// every generic test, including those whose values are not flags, must compile
+template struct TestDeque< MyDeque<bool> >;
+
+// -------------
+// TestBoolDeque
+// -------------
+
+// the generic tests whose values carry over to flags
+
+struct TestBoolDeque : TestDeque< MyDeque<bool> > {
+    CPPUNIT_TEST_SUITE(TestBoolDeque);
+    CPPUNIT_TEST(test_constructor_1);
+    CPPUNIT_TEST(test_constructor_2);
+    CPPUNIT_TEST(test_constructor_3);
+    CPPUNIT_TEST(test_constructor_4);
+    CPPUNIT_TEST(test_index_1);
+    CPPUNIT_TEST(test_at_2);
+    CPPUNIT_TEST(test_at_3);
+    CPPUNIT_TEST(test_size_1);
+    CPPUNIT_TEST(test_size_2);
+    CPPUNIT_TEST(test_size_3);
+    CPPUNIT_TEST(test_size_4);
+    CPPUNIT_TEST(test_size_5);
+    CPPUNIT_TEST(test_assignment_1);
+    CPPUNIT_TEST(test_assignment_2);
+    CPPUNIT_TEST(test_assignment_3);
+    CPPUNIT_TEST(test_back_1);
+    CPPUNIT_TEST(test_back_3);
+    CPPUNIT_TEST(test_begin_2);
+    CPPUNIT_TEST(test_begin_3);
+    CPPUNIT_TEST(test_end_1);
+    CPPUNIT_TEST(test_end_3);
+    CPPUNIT_TEST(test_equals_1);
+    CPPUNIT_TEST(test_equals_2);
+    CPPUNIT_TEST(test_equals_3);
+    CPPUNIT_TEST(test_lessthan_2);
+    CPPUNIT_TEST(test_lessthan_3);
+    CPPUNIT_TEST(test_iterator_equals_1);
+    CPPUNIT_TEST(test_iterator_equals_2);
+    CPPUNIT_TEST(test_iterator_equals_3);
+    CPPUNIT_TEST(test_front_1);
+    CPPUNIT_TEST(test_front_2);
+    CPPUNIT_TEST(test_front_3);
+    CPPUNIT_TEST(test_erase_2);
+    CPPUNIT_TEST(test_swap_2);
+    CPPUNIT_TEST(test_push_front_2);
+    CPPUNIT_TEST(test_push_front_6);
+    CPPUNIT_TEST(test_pop_front_2);
+    CPPUNIT_TEST(test_pop_front_4);
+    CPPUNIT_TEST(test_pop_back_2);
+    CPPUNIT_TEST_SUITE_END();};
+
+// -----------
+// TestMyDeque
+// -----------
+
+// MyDeque operations that std::deque does not have
+
+struct TestMyDeque : CppUnit::TestFixture {
+    typedef MyDeque<int> C;
+
+    // builds a deque of n elements 0, 1, ... whose first element is in column n of a row of 3 * n
+    static C make (int n, int from = 0) {
+        C x(n);
+        for (int i = 0; i != n; ++i)
+            x[i] = from + i;
+        return x;}
+
+    // value is B, as a C++11 std::integral_constant would have it
+    template <bool B>
+    struct flag {
+        enum {value = B};};
+
+    // an allocator that is equal only to copies of itself and counts what is live in its pool
+    template <typename T, bool P>
+    struct Pool : std::allocator<T> {
+        typedef flag<P> propagate_on_container_copy_assignment;
+        typedef flag<P> propagate_on_container_swap;
+
+        template <typename U>
+        struct rebind {
+            typedef Pool<U, P> other;};
+
+        int id;
+        long* live;
+
+        Pool (int i, long& n) : id(i), live(&n) {}
+
+        template <typename U>
+        Pool (const Pool<U, P>& that) : std::allocator<T>(), id(that.id), live(that.live) {}
+
+        T* allocate (std::size_t n) {
+            *live += n;
+            return std::allocator<T>::allocate(n);}
+
+        void deallocate (T* p, std::size_t n) {
+            *live -= n;
+            std::allocator<T>::deallocate(p, n);}
+
+        bool operator == (const Pool& that) const {
+            return id == that.id;}};
+
+    // ------
+    // splice
+    // ------
+
+    void test_splice_back_1 () {
+        C a = make(10);
+        C b(10);
+        for (int i = 10; i != 40; ++i)
+            b.push_back(i);
+        for (int i = 0; i != 10; ++i)
+            b.pop_front();
+        int* p = &b[29];
+        a.splice_back(b);
+        CPPUNIT_ASSERT(a.size() == 40);
+        CPPUNIT_ASSERT(b.empty());
+        for (int i = 0; i != 40; ++i)
+            CPPUNIT_ASSERT(a[i] == i);
+        CPPUNIT_ASSERT(&a[39] == p);}
+
+    void test_splice_back_2 () {
+        C a = make(10);
+        C b = make(5, 10);
+        a.splice_back(b);
+        CPPUNIT_ASSERT(a.size() == 15);
+        CPPUNIT_ASSERT(b.empty());
+        for (int i = 0; i != 15; ++i)
+            CPPUNIT_ASSERT(a[i] == i);}
+
+    void test_splice_back_3 () {
+        C a = make(10);
+        C b = make(10, 10);
+        C c = b.split_at(10);
+        c.splice_back(a);
+        CPPUNIT_ASSERT(c.size() == 10);
+        CPPUNIT_ASSERT(c.front() == 0);
+        CPPUNIT_ASSERT(a.empty());}
+
+    void test_splice_back_4 () {
+        C a = make(3);
+        const C::handle_type h = a.handle(1);
+        C b;
+        for (int i = 3; i != 1000; ++i)
+            b.push_back(i);
+        int* p = &b[0];
+        a.splice_back(b);
+        CPPUNIT_ASSERT(a.size() == 1000);
+        CPPUNIT_ASSERT(b.empty());
+        for (int i = 0; i != 1000; ++i)
+            CPPUNIT_ASSERT(a[i] == i);
+        CPPUNIT_ASSERT(&a[3] == p);
+        CPPUNIT_ASSERT(a.get(h) == 1);}
+
+    void test_splice_back_5 () {
+        C a;
+        for (int i = 0; i != 1000; ++i)
+            a.push_back(i);
+        const int* const p = &a[0];
+        const int* const q = &a[342];
+        const int* const r = &a[999];
+        C b = a.split_at(342);
+        CPPUNIT_ASSERT(&a[0] == p);
+        CPPUNIT_ASSERT(&b[0] == q);
+        CPPUNIT_ASSERT(&b[657] == r);
+        a.splice_back(b);
+        CPPUNIT_ASSERT(b.empty());
+        CPPUNIT_ASSERT(a.size() == 1000);
+        for (int i = 0; i != 1000; ++i)
+            CPPUNIT_ASSERT(a[i] == i);
+        CPPUNIT_ASSERT(&a[342] == q);
+        CPPUNIT_ASSERT(&a[999] == r);
+        C c = a.split_at(342);
+        c.splice_front(a);
+        CPPUNIT_ASSERT(a.empty());
+        CPPUNIT_ASSERT(c.size() == 1000);
+        for (int i = 0; i != 1000; ++i)
+            CPPUNIT_ASSERT(c[i] == i);
+        CPPUNIT_ASSERT(&c[0] == p);
+        CPPUNIT_ASSERT(&c[342] == q);
+        c.push_back(1000);
+        CPPUNIT_ASSERT(c.back() == 1000);}
+
+    void test_splice_front_1 () {
+        C a = make(10, 30);
+        C b = make(10);
+        for (int i = 10; i != 25; ++i)
+            b.push_back(i);
+        for (int i = 29; i != 24; --i)
+            a.push_front(i);
+        int* p = &b[0];
+        a.splice_front(b);
+        CPPUNIT_ASSERT(a.size() == 40);
+        CPPUNIT_ASSERT(b.empty());
+        for (int i = 0; i != 40; ++i)
+            CPPUNIT_ASSERT(a[i] == i);
+        CPPUNIT_ASSERT(&a[0] == p);}
+
+    void test_splice_front_2 () {
+        C a = make(10, 5);
+        C b = make(5);
+        a.splice_front(b);
+        CPPUNIT_ASSERT(a.size() == 15);
+        CPPUNIT_ASSERT(b.empty());
+        for (int i = 0; i != 15; ++i)
+            CPPUNIT_ASSERT(a[i] == i);}
+
+    void test_splice_front_3 () {
+        C a = make(3, 997);
+        const C::handle_type h = a.handle(1);
+        C b;
+        for (int i = 0; i != 997; ++i)
+            b.push_back(i);
+        int* p = &b[0];
+        a.splice_front(b);
+        CPPUNIT_ASSERT(a.size() == 1000);
+        CPPUNIT_ASSERT(b.empty());
+        for (int i = 0; i != 1000; ++i)
+            CPPUNIT_ASSERT(a[i] == i);
+        CPPUNIT_ASSERT(&a[0] == p);
+        CPPUNIT_ASSERT(a.get(h) == 998);}
+
+    // --------
+    // split_at
+    // --------
+
+    void test_split_at_1 () {
+        C a = make(10);
+        for (int i = 10; i != 100; ++i)
+            a.push_back(i);
+        int* p = &a[99];
+        C b = a.split_at(40);
+        CPPUNIT_ASSERT(a.size() == 40);
+        CPPUNIT_ASSERT(b.size() == 60);
+        for (int i = 0; i != 40; ++i)
+            CPPUNIT_ASSERT(a[i] == i);
+        for (int i = 0; i != 60; ++i)
+            CPPUNIT_ASSERT(b[i] == 40 + i);
+        CPPUNIT_ASSERT(&b[59] == p);}
+
+    void test_split_at_2 () {
+        C a = make(10);
+        for (int i = 10; i != 100; ++i)
+            a.push_back(i);
+        C b = a.split_at(40);
+        a.splice_back(b);
+        CPPUNIT_ASSERT(a.size() == 100);
+        for (int i = 0; i != 100; ++i)
+            CPPUNIT_ASSERT(a[i] == i);}
+
+    void test_split_at_3 () {
+        C a = make(10);
+        C b = a.split_at(10);
+        CPPUNIT_ASSERT(a.size() == 10);
+        CPPUNIT_ASSERT(b.empty());
+        try {
+            a.split_at(11);
+            CPPUNIT_ASSERT(false);}
+        catch (std::out_of_range& e) {
+            CPPUNIT_ASSERT(true);}}
+
+    // ----
+    // find
+    // ----
+
+    void test_find_1 () {
+        C a = make(10);
+        for (int i = 10; i != 100; ++i)
+            a.push_back(i);
+        CPPUNIT_ASSERT(find(a, 77) == a.begin() + 77);
+        CPPUNIT_ASSERT(find(a, 100) == a.end());
+        const C& b = a;
+        CPPUNIT_ASSERT(*find(b, 3) == 3);}
+
+    void test_find_2 () {
+        MyDeque<float> a(50, 1.5f);
+        a.push_back(2.5f);
+        a.push_back(2.5f);
+        CPPUNIT_ASSERT(find(a, 2.5f) == a.begin() + 50);
+        CPPUNIT_ASSERT(find(a, 0.0f) == a.end());}
+
+    // -----
+    // count
+    // -----
+
+    void test_count_1 () {
+        C a = make(10);
+        for (int i = 10; i != 100; ++i)
+            a.push_back(i % 7);
+        CPPUNIT_ASSERT(count(a, 3) == 14);
+        CPPUNIT_ASSERT(count(a, -1) == 0);}
+
+    void test_count_2 () {
+        MyDeque<uint64_t> a(40, 5);
+        a[39] = 6;
+        a.push_front(6);
+        CPPUNIT_ASSERT(count(a, uint64_t(5)) == 39);
+        CPPUNIT_ASSERT(count(a, uint64_t(6)) == 2);}
+
+    // --------
+    // min, max
+    // --------
+
+    void test_min_1 () {
+        C a = make(10);
+        for (int i = 10; i != 100; ++i)
+            a.push_back(i);
+        a[63] = -5;
+        CPPUNIT_ASSERT(min(a) == -5);
+        CPPUNIT_ASSERT(max(a) == 99);}
+
+    void test_min_2 () {
+        MyDeque<double> a(33, 0.5);
+        a[32] = 7.0;
+        a.push_front(-1.0);
+        CPPUNIT_ASSERT(min(a) == -1.0);
+        CPPUNIT_ASSERT(max(a) == 7.0);}
+
+    void test_max_1 () {
+        MyDeque<uint64_t> a(20, 1);
+        a[5] = uint64_t(1) << 63;
+        CPPUNIT_ASSERT(max(a) == uint64_t(1) << 63);
+        CPPUNIT_ASSERT(min(a) == 1);}
+
+    // ---
+    // sum
+    // ---
+
+    void test_sum_1 () {
+        C a = make(10);
+        for (int i = 10; i != 100; ++i)
+            a.push_back(i);
+        CPPUNIT_ASSERT(sum(a) == 4950);
+        CPPUNIT_ASSERT(sum(C(1, 0)) == 0);}
+
+    void test_sum_2 () {
+        MyDeque<uint64_t> a(100, 3);
+        CPPUNIT_ASSERT(sum(a) == 300);}
+
+    // -----------------
+    // equals, less than
+    // -----------------
+
+    void test_equals_1 () {
+        C a = make(10);
+        C b = make(100);
+        for (int i = 10; i != 100; ++i)
+            a.push_back(i);
+        CPPUNIT_ASSERT(a == b);
+        b[97] = 0;
+        CPPUNIT_ASSERT(!(a == b));
+        CPPUNIT_ASSERT(b < a);}
+
+    void test_lessthan_1 () {
+        C a = make(50);
+        C b = make(60);
+        CPPUNIT_ASSERT(a < b);
+        CPPUNIT_ASSERT(!(b < a));
+        CPPUNIT_ASSERT(!(a < a));}
+
+    void test_lessthan_2 () {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        const float x[] = {1, nan, 2};
+        const float y[] = {1, 0, 3};
+        MyDeque<float> a(3);
+        MyDeque<float> b(3);
+        std::copy(x, x + 3, a.begin());
+        std::copy(y, y + 3, b.begin());
+        CPPUNIT_ASSERT((a < b) == std::lexicographical_compare(x, x + 3, y, y + 3));
+        CPPUNIT_ASSERT(!(a == a));}
+
+    // -------
+    // storage
+    // -------
+
+    void test_default_1 () {
+        C x;
+        for (int i = 0; i != 1000; ++i) {
+            x.push_back(i);
+            x.push_front(-i);}
+        CPPUNIT_ASSERT(x.size() == 2000);
+        CPPUNIT_ASSERT(x.front() == -999);
+        CPPUNIT_ASSERT(x.back() == 999);
+        C y(x);
+        CPPUNIT_ASSERT(x == y);}
+
+    void test_pop_front_1 () {
+        C x(2);
+        for (int i = 0; i != 100; ++i)
+            x.push_back(i);
+        for (int i = 0; i != 2; ++i)
+            x.pop_front();
+        for (int i = 0; i != 100; ++i) {
+            CPPUNIT_ASSERT(x.front() == i);
+            CPPUNIT_ASSERT(x[99 - i] == 99);
+            x.pop_front();}
+        CPPUNIT_ASSERT(x.empty());
+        x.push_back(5);
+        CPPUNIT_ASSERT(x.front() == 5);}
+
+    void test_resize_1 () {
+        C x(2, 1);
+        x.resize(50, 7);
+        CPPUNIT_ASSERT(x.size() == 50);
+        CPPUNIT_ASSERT(x[1] == 1);
+        CPPUNIT_ASSERT(x[2] == 7);
+        CPPUNIT_ASSERT(x[49] == 7);}
+
+    // -----------
+    // pop_front_n
+    // -----------
+
+    void test_pop_front_n_1 () {
+        MyDeque<std::string> x(5);
+        x.clear();
+        std::deque<std::string> y;
+        for (int i = 0; i != 100; ++i) {
+            const std::string s(i % 4 + 1, char('a' + i % 26));
+            x.push_back(s);
+            y.push_back(s);}
+        for (int n = 0; !y.empty(); ++n) {
+            const int k = std::min(n, int(y.size()));
+            x.pop_front_n(k);
+            y.erase(y.begin(), y.begin() + k);
+            CPPUNIT_ASSERT(x.size() == y.size());
+            CPPUNIT_ASSERT(std::equal(x.begin(), x.end(), y.begin()));}
+        x.push_back("z");
+        CPPUNIT_ASSERT(x.front() == "z");}
+
+    void test_pop_back_n_1 () {
+        MyDeque<std::string> x(4);
+        x.clear();
+        std::deque<std::string> y;
+        for (int i = 0; i != 100; ++i) {
+            const std::string s(i % 4 + 1, char('a' + i % 26));
+            x.push_front(s);
+            y.push_front(s);}
+        for (int n = 0; !y.empty(); ++n) {
+            const int k = std::min(n, int(y.size()));
+            x.pop_back_n(k);
+            y.erase(y.end() - k, y.end());
+            CPPUNIT_ASSERT(x.size() == y.size());
+            CPPUNIT_ASSERT(std::equal(x.begin(), x.end(), y.begin()));}
+        x.push_front("z");
+        CPPUNIT_ASSERT(x.back() == "z");}
+
+    // -----
+    // drain
+    // -----
+
+    void test_drain_front_1 () {
+        C x(7);
+        x.clear();
+        for (int i = 0; i != 100; ++i)
+            x.push_back(i);
+        std::vector<int> v;
+        x.drain_front(30, std::back_inserter(v));
+        CPPUNIT_ASSERT(v.size() == 30);
+        CPPUNIT_ASSERT(v[29] == 29);
+        CPPUNIT_ASSERT(x.front() == 30);
+        int a[100];
+        CPPUNIT_ASSERT(x.drain_front(100, a) == a + 70);
+        CPPUNIT_ASSERT(a[0] == 30);
+        CPPUNIT_ASSERT(a[69] == 99);
+        CPPUNIT_ASSERT(x.empty());}
+
+    void test_drain_back_1 () {
+        C x(7);
+        x.clear();
+        for (int i = 0; i != 100; ++i)
+            x.push_front(i);
+        int a[100];
+        CPPUNIT_ASSERT(x.drain_back(30, a) == a + 30);
+        CPPUNIT_ASSERT(a[0] == 0);
+        CPPUNIT_ASSERT(a[29] == 29);
+        CPPUNIT_ASSERT(x.back() == 30);
+        CPPUNIT_ASSERT(x.size() == 70);
+        CPPUNIT_ASSERT(x.drain_back(100, a) == a + 70);
+        CPPUNIT_ASSERT(a[69] == 99);
+        CPPUNIT_ASSERT(x.empty());}
+
+    // -------
+    // handles
+    // -------
+
+    void test_handle_1 () {
+        C x(3);
+        x.clear();
+        for (int i = 0; i != 10; ++i)
+            x.push_back(i);
+        const C::handle_type h = x.handle(4);
+        for (int i = 0; i != 20; ++i)
+            x.push_front(-i);
+        CPPUNIT_ASSERT(x.contains(h));
+        CPPUNIT_ASSERT(x.get(h) == 4);
+        CPPUNIT_ASSERT(x.position(h) == 24);
+        x.pop_front_n(23);
+        x.push_back(10);
+        CPPUNIT_ASSERT(x.position(h) == 1);
+        x.get(h) = 40;
+        CPPUNIT_ASSERT(x[1] == 40);
+        x.pop_front();
+        x.pop_front();
+        CPPUNIT_ASSERT(!x.contains(h));
+        const C::handle_type k = x.handle(x.size() - 1);
+        x.pop_back();
+        CPPUNIT_ASSERT(!x.contains(k));
+        x.push_back(11);
+        CPPUNIT_ASSERT(x.get(k) == 11);}
+
+    void test_handle_2 () {
+        C x = make(5);
+        const C::handle_type h = x.handle(2);
+        const C::handle_type k = x.handle(4);
+        C y = x.split_at(3);
+        CPPUNIT_ASSERT(x.get(h) == 2);
+        CPPUNIT_ASSERT(!x.contains(k));
+        CPPUNIT_ASSERT(y.contains(k));
+        CPPUNIT_ASSERT(y.get(k) == 4);
+        C z(y);
+        CPPUNIT_ASSERT(z.get(k) == 4);
+        y.pop_back();
+        x.splice_front(y);
+        CPPUNIT_ASSERT(x.get(h) == 2);
+        CPPUNIT_ASSERT(x.front() == 3);
+        x.swap(z);
+        CPPUNIT_ASSERT(x.get(k) == 4);
+        CPPUNIT_ASSERT(z.get(h) == 2);}
+
+    void test_handle_3 () {
+        C x = make(5);
+        const C::handle_type h = x.handle(0);
+        const C::handle_type k = x.handle(x.size() - 1);
+        for (int j = 0; j != 4; ++j) {
+            x.clear();
+            CPPUNIT_ASSERT(!x.contains(h));
+            for (int i = 0; i != 100; ++i) {
+                x.push_back(i);
+                x.push_front(i);}
+            CPPUNIT_ASSERT(!x.contains(h));
+            CPPUNIT_ASSERT(!x.contains(k));}
+        x.clear();
+        x.clear();
+        x.push_back(0);
+        CPPUNIT_ASSERT(!x.contains(h));
+        C y = make(5);
+        const C::handle_type g = y.handle(1);
+        x.splice_back(y);
+        CPPUNIT_ASSERT(!y.contains(g));
+        for (int i = 0; i != 100; ++i) {
+            y.push_back(i);
+            y.push_front(i);}
+        CPPUNIT_ASSERT(!y.contains(g));}
+
+    void test_handle_4 () {
+        MyDeque<bool> x;
+        for (int i = 0; i != 200; ++i)
+            x.push_back(i % 3 == 0);
+        const MyDeque<bool>::handle_type h = x.handle(150);
+        CPPUNIT_ASSERT(x.get(h));
+        x.pop_front_n(100);
+        x.push_front(false);
+        CPPUNIT_ASSERT(x.position(h) == 51);
+        x.get(h) = false;
+        CPPUNIT_ASSERT(!x[51]);
+        MyDeque<bool> y = x.split_at(20);
+        CPPUNIT_ASSERT(!x.contains(h));
+        CPPUNIT_ASSERT(y.position(h) == 31);
+        const MyDeque<bool>::handle_type k = x.handle(0);
+        x.splice_front(y);
+        CPPUNIT_ASSERT(!y.contains(h));
+        CPPUNIT_ASSERT(x.position(k) == 81);
+        y.splice_back(x);
+        CPPUNIT_ASSERT(y.position(k) == 81);
+        y.clear();
+        y.clear();
+        for (int i = 0; i != 200; ++i) {
+            y.push_back(true);
+            y.push_front(true);}
+        CPPUNIT_ASSERT(!y.contains(h));
+        CPPUNIT_ASSERT(!y.contains(k));}
+
+    // ----------
+    // assignment
+    // ----------
+
+    void test_assign_1 () {
+        MyDeque<std::string> x(3, "a");
+        MyDeque<std::string> y;
+        for (int i = 0; i != 50; ++i)
+            y.push_back(std::string(i % 7 + 1, char('a' + i % 26)));
+        x = y;
+        CPPUNIT_ASSERT(x == y);
+        y.pop_front_n(45);
+        x = y;
+        CPPUNIT_ASSERT(x == y);
+        CPPUNIT_ASSERT(x.size() == 5);
+        x = MyDeque<std::string>();
+        CPPUNIT_ASSERT(x.empty());
+        MyDeque<std::string> z;
+        z = y;
+        CPPUNIT_ASSERT(z == y);}
+
+    void test_assign_2 () {
+        long m = 0;
+        long n = 0;
+        {
+        typedef MyDeque< int, Pool<int, false> > D;
+        D x(Pool<int, false>(1, m));
+        D y(Pool<int, false>(2, n));
+        for (int i = 0; i != 100; ++i)
+            y.push_back(i);
+        const long before = n;
+        x = y;
+        CPPUNIT_ASSERT(x == y);
+        CPPUNIT_ASSERT(x.get_allocator().id == 1);
+        CPPUNIT_ASSERT(n == before);
+        y.pop_back_n(90);
+        x = y;
+        CPPUNIT_ASSERT(x == y);
+        }
+        CPPUNIT_ASSERT(m == 0);
+        CPPUNIT_ASSERT(n == 0);}
+
+    void test_assign_3 () {
+        long m = 0;
+        long n = 0;
+        {
+        typedef MyDeque< int, Pool<int, true> > D;
+        D x(Pool<int, true>(1, m));
+        D y(Pool<int, true>(2, n));
+        for (int i = 0; i != 100; ++i) {
+            x.push_back(-i);
+            y.push_back(i);}
+        x = y;
+        CPPUNIT_ASSERT(x == y);
+        CPPUNIT_ASSERT(x.get_allocator().id == 2);
+        CPPUNIT_ASSERT(m == 0);
+        }
+        CPPUNIT_ASSERT(n == 0);}
+
+    // ----
+    // swap
+    // ----
+
+    void test_swap_1 () {
+        long m = 0;
+        long n = 0;
+        {
+        typedef MyDeque< int, Pool<int, false> > D;
+        D x(Pool<int, false>(1, m));
+        D y(Pool<int, false>(2, n));
+        for (int i = 0; i != 1000; ++i)
+            x.push_back(i);
+        for (int i = 0; i != 30; ++i)
+            y.push_front(-i);
+        const D::handle_type h = x.handle(500);
+        const D a(x);
+        const D b(y);
+        x.swap(y);
+        CPPUNIT_ASSERT(x == b);
+        CPPUNIT_ASSERT(y == a);
+        CPPUNIT_ASSERT(x.get_allocator().id == 1);
+        CPPUNIT_ASSERT(y.get_allocator().id == 2);
+        CPPUNIT_ASSERT(y.get(h) == 500);
+        y.swap(x);
+        CPPUNIT_ASSERT(x == a);
+        CPPUNIT_ASSERT(y == b);
+        }
+        CPPUNIT_ASSERT(m == 0);
+        CPPUNIT_ASSERT(n == 0);}
+
+    void test_swap_2 () {
+        long m = 0;
+        long n = 0;
+        {
+        typedef MyDeque< int, Pool<int, true> > D;
+        D x(Pool<int, true>(1, m));
+        D y(Pool<int, true>(2, n));
+        for (int i = 0; i != 1000; ++i)
+            x.push_back(i);
+        y.push_back(-1);
+        const long before = m + n;
+        x.swap(y);
+        CPPUNIT_ASSERT(m + n == before);
+        CPPUNIT_ASSERT(x.get_allocator().id == 2);
+        CPPUNIT_ASSERT(y.get_allocator().id == 1);
+        CPPUNIT_ASSERT(x.size() == 1);
+        CPPUNIT_ASSERT(y.back() == 999);
+        }
+        CPPUNIT_ASSERT(m == 0);
+        CPPUNIT_ASSERT(n == 0);}
+
+    // ----
+    // bool
+    // ----
+
+    void test_bool_1 () {
+        MyDeque<bool> x;
+        std::deque<bool> y;
+        std::srand(0);
+        for (int i = 0; i != 5000; ++i) {
+            const int r = std::rand() % 5;
+            const bool v = std::rand() % 3;
+            if (r < 2) {
+                x.push_back(v);
+                y.push_back(v);}
+            else if (r < 4) {
+                x.push_front(v);
+                y.push_front(v);}
+            else if (!y.empty() && (i % 2)) {
+                x.pop_back();
+                y.pop_back();}
+            else if (!y.empty()) {
+                x.pop_front();
+                y.pop_front();}}
+        CPPUNIT_ASSERT(x.size() == y.size());
+        CPPUNIT_ASSERT(std::equal(x.begin(), x.end(), y.begin()));
+        CPPUNIT_ASSERT(x.words().size() <= y.size() / 64 + 2);
+        CPPUNIT_ASSERT(count(x, true) == std::size_t(std::count(y.begin(), y.end(), true)));
+        CPPUNIT_ASSERT(count(x, false) == std::size_t(std::count(y.begin(), y.end(), false)));}
+
+    void test_bool_2 () {
+        MyDeque<bool> x(200, true);
+        CPPUNIT_ASSERT(x.count() == 200);
+        x[3] = false;
+        x[150].flip();
+        CPPUNIT_ASSERT(!x[3]);
+        CPPUNIT_ASSERT(!x.at(150));
+        CPPUNIT_ASSERT(x.count() == 198);
+        CPPUNIT_ASSERT(x.find_first(false) == 3);
+        x[0] = x[3];
+        CPPUNIT_ASSERT(x.find_first(false) == 0);
+        CPPUNIT_ASSERT(*find(x, false) == false);
+        try {
+            x.at(200);
+            CPPUNIT_ASSERT(false);}
+        catch (std::out_of_range&) {}}
+
+    void test_bool_3 () {
+        MyDeque<bool> x(1000, false);
+        CPPUNIT_ASSERT(x.find_first(true) == 1000);
+        x[999] = true;
+        x[700] = true;
+        x.push_front(false);
+        CPPUNIT_ASSERT(x.find_first() == 701);
+        x.pop_front_n(650);
+        CPPUNIT_ASSERT(x.size() == 351);
+        CPPUNIT_ASSERT(x.find_first() == 51);
+        CPPUNIT_ASSERT(x.count() == 2);
+        x.pop_back_n(2);
+        CPPUNIT_ASSERT(x.count() == 1);
+        CPPUNIT_ASSERT(x.find_first(false) == 0);
+        x.pop_front_n(x.size());
+        CPPUNIT_ASSERT(x.empty());
+        CPPUNIT_ASSERT(x.words().empty());}
+
+    void test_bool_4 () {
+        MyDeque<bool> x;
+        x.push_front(true);
+        x.resize(300, true);
+        CPPUNIT_ASSERT(x.count() == 300);
+        x.resize(130);
+        x.resize(140, false);
+        CPPUNIT_ASSERT(x.count() == 130);
+        CPPUNIT_ASSERT(x.find_first(false) == 130);
+        MyDeque<bool> y(140, true);
+        y.resize(130);
+        y.resize(140);
+        CPPUNIT_ASSERT(x == y);
+        y.pop_front();
+        y.push_front(true);
+        CPPUNIT_ASSERT(x == y);
+        y.back() = true;
+        CPPUNIT_ASSERT(x < y);}
+
+    void test_bool_7 () {
+        MyDeque<bool> x;
+        for (int i = 0; i != 300; ++i)
+            x.push_back(i % 3 == 0);
+        std::vector<bool> v;
+        x.drain_front(70, std::back_inserter(v));
+        CPPUNIT_ASSERT(v.size() == 70);
+        CPPUNIT_ASSERT(v[0] && !v[1] && v[69]);
+        CPPUNIT_ASSERT(x.size() == 230);
+        CPPUNIT_ASSERT(!x.front());
+        bool a[300];
+        CPPUNIT_ASSERT(x.drain_back(100, a) == a + 100);
+        CPPUNIT_ASSERT(!a[0] && !a[1] && a[2]);
+        CPPUNIT_ASSERT(x.size() == 130);
+        CPPUNIT_ASSERT(x.back() == (199 % 3 == 0));
+        CPPUNIT_ASSERT(x.count() == 43);
+        CPPUNIT_ASSERT(x.drain_front(300, a) == a + 130);
+        CPPUNIT_ASSERT(!a[0] && !a[1] && a[2]);
+        CPPUNIT_ASSERT(x.empty());}
+
+    void test_bool_8 () {
+        MyDeque<bool> x;
+        for (int i = 0; i != 100000; ++i)
+            x.push_back(i % 7 == 0);
+        x.pop_front_n(70001);
+        CPPUNIT_ASSERT(x.size() == 29999);
+        CPPUNIT_ASSERT(!x.front());
+        CPPUNIT_ASSERT(x[6]);
+        CPPUNIT_ASSERT(x.words().size() == (x.offset() + 29999 + MyDeque<bool>::bitsPerWord - 1) / MyDeque<bool>::bitsPerWord);
+        x.pop_back_n(29000);
+        CPPUNIT_ASSERT(x.size() == 999);
+        CPPUNIT_ASSERT(x.back() == ((70001 + 998) % 7 == 0));
+        CPPUNIT_ASSERT(x.words().size() == (x.offset() + 999 + MyDeque<bool>::bitsPerWord - 1) / MyDeque<bool>::bitsPerWord);
+        x.pop_back_n(999);
+        CPPUNIT_ASSERT(x.empty());
+        CPPUNIT_ASSERT(x.words().empty());}
+
+    void test_bool_5 () {
+        MyDeque<bool> x;
+        std::deque<bool> y;
+        std::srand(0);
+        for (int i = 0; i != 3000; ++i) {
+            const int r = std::rand() % 4;
+            const bool v = std::rand() % 2;
+            const int k = std::rand() % (y.size() + 1);
+            if (r < 2) {
+                CPPUNIT_ASSERT(*x.insert(x.begin() + k, v) == v);
+                y.insert(y.begin() + k, v);}
+            else if (r == 2) {
+                x.push_back(v);
+                y.push_back(v);}
+            else if (k != int(y.size())) {
+                x.erase(x.begin() + k);
+                y.erase(y.begin() + k);}}
+        CPPUNIT_ASSERT(x.size() == y.size());
+        CPPUNIT_ASSERT(std::equal(x.begin(), x.end(), y.begin()));
+        CPPUNIT_ASSERT(x.get_allocator() == std::allocator<bool>());
+        CPPUNIT_ASSERT(sum(x) == (count(x, true) != 0));
+        CPPUNIT_ASSERT(!min(x));
+        CPPUNIT_ASSERT(max(x));
+        std::size_t c = 0;
+        std::size_t n;
+        for (std::size_t i = 0; i != x.size(); i += n) {
+            const MyDeque<bool>::word* p = x.segment(i, n);
+            for (std::size_t j = 0; j != n; ++j) {
+                const std::size_t g = x.offset() + i + j - (x.offset() + i) / MyDeque<bool>::bitsPerWord * MyDeque<bool>::bitsPerWord;
+                c += (p[g / MyDeque<bool>::bitsPerWord] >> (g % MyDeque<bool>::bitsPerWord)) & 1;}}
+        CPPUNIT_ASSERT(c == count(x, true));}
+
+    void test_bool_6 () {
+        for (int s = 0; s < 200; s += 7)
+            for (int t = 0; t < 200; t += 13) {
+                MyDeque<bool> x;
+                MyDeque<bool> y;
+                std::deque<bool> z;
+                for (int i = 0; i != s; ++i) {
+                    x.push_front(i % 3 == 0);
+                    z.push_front(i % 3 == 0);}
+                std::deque<bool> w;
+                for (int i = 0; i != t; ++i) {
+                    y.push_back(i % 5 < 2);
+                    w.push_back(i % 5 < 2);}
+                if ((s + t) % 2) {
+                    x.splice_back(y);
+                    z.insert(z.end(), w.begin(), w.end());}
+                else {
+                    x.splice_front(y);
+                    z.insert(z.begin(), w.begin(), w.end());}
+                CPPUNIT_ASSERT(y.empty());
+                CPPUNIT_ASSERT(x.size() == z.size());
+                CPPUNIT_ASSERT(std::equal(x.begin(), x.end(), z.begin()));
+                const std::size_t pos = (s * 31 + t) % (z.size() + 1);
+                MyDeque<bool> u = x.split_at(pos);
+                CPPUNIT_ASSERT(x.size() == pos);
+                CPPUNIT_ASSERT(u.size() == z.size() - pos);
+                CPPUNIT_ASSERT(std::equal(x.begin(), x.end(), z.begin()));
+                CPPUNIT_ASSERT(std::equal(u.begin(), u.end(), z.begin() + pos));
+                CPPUNIT_ASSERT(u.count() + x.count() == std::size_t(std::count(z.begin(), z.end(), true)));}}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestMyDeque);
+    CPPUNIT_TEST(test_splice_back_1);
+    CPPUNIT_TEST(test_splice_back_2);
+    CPPUNIT_TEST(test_splice_back_3);
+    CPPUNIT_TEST(test_splice_back_4);
+    CPPUNIT_TEST(test_splice_back_5);
+    CPPUNIT_TEST(test_splice_front_1);
+    CPPUNIT_TEST(test_splice_front_2);
+    CPPUNIT_TEST(test_splice_front_3);
+    CPPUNIT_TEST(test_split_at_1);
+    CPPUNIT_TEST(test_split_at_2);
+    CPPUNIT_TEST(test_split_at_3);
+    CPPUNIT_TEST(test_find_1);
+    CPPUNIT_TEST(test_find_2);
+    CPPUNIT_TEST(test_count_1);
+    CPPUNIT_TEST(test_count_2);
+    CPPUNIT_TEST(test_min_1);
+    CPPUNIT_TEST(test_min_2);
+    CPPUNIT_TEST(test_max_1);
+    CPPUNIT_TEST(test_sum_1);
+    CPPUNIT_TEST(test_sum_2);
+    CPPUNIT_TEST(test_equals_1);
+    CPPUNIT_TEST(test_lessthan_1);
+    CPPUNIT_TEST(test_lessthan_2);
+    CPPUNIT_TEST(test_default_1);
+    CPPUNIT_TEST(test_pop_front_1);
+    CPPUNIT_TEST(test_resize_1);
+    CPPUNIT_TEST(test_pop_front_n_1);
+    CPPUNIT_TEST(test_pop_back_n_1);
+    CPPUNIT_TEST(test_drain_front_1);
+    CPPUNIT_TEST(test_drain_back_1);
+    CPPUNIT_TEST(test_handle_1);
+    CPPUNIT_TEST(test_handle_2);
+    CPPUNIT_TEST(test_handle_3);
+    CPPUNIT_TEST(test_handle_4);
+    CPPUNIT_TEST(test_assign_1);
+    CPPUNIT_TEST(test_assign_2);
+    CPPUNIT_TEST(test_assign_3);
+    CPPUNIT_TEST(test_swap_1);
+    CPPUNIT_TEST(test_swap_2);
+    CPPUNIT_TEST(test_bool_1);
+    CPPUNIT_TEST(test_bool_2);
+    CPPUNIT_TEST(test_bool_3);
+    CPPUNIT_TEST(test_bool_4);
+    CPPUNIT_TEST(test_bool_5);
+    CPPUNIT_TEST(test_bool_6);
+    CPPUNIT_TEST(test_bool_7);
+    CPPUNIT_TEST(test_bool_8);
     CPPUNIT_TEST_SUITE_END();};
 
 // ----
@@ -721,6 +1685,8 @@ int main () {
     CppUnit::TextTestRunner tr;
     tr.addTest(TestDeque< MyDeque<int> >::suite());
     tr.addTest(TestDeque< deque<int> >::suite());
+    tr.addTest(TestBoolDeque::suite());
+    tr.addTest(TestMyDeque::suite());
     tr.run();
 
     cout << "Done." << endl;
@@ -0,0 +1,295 @@
+// --------------------------------------
+// projects/deque/TestPersistentDeque.c++
+// Copyright (C) 2012
+// Glenn P. Downing
+// --------------------------------------
+
+/*
+To test the program:
+% g++ -ansi -pedantic -lcppunit -ldl -Wall TestPersistentDeque.c++ -o TestPersistentDeque.c++.app
+% valgrind TestPersistentDeque.c++.app >& TestPersistentDeque.out
+*/
+
+// --------
+// includes
+// --------
+
+#include <deque> // deque
+#include <stdexcept> // out_of_range
+#include <vector> // vector
+
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE_END
+#include "cppunit/TestFixture.h" // TestFixture
+#include "cppunit/TextTestRunner.h" // TestRunner
+
+#include "PersistentDeque.h"
+
+// -------------------
+// TestPersistentDeque
+// -------------------
+
+struct TestPersistentDeque : CppUnit::TestFixture {
+    typedef PersistentDeque<int> P;
+
+    /**
+     * counts the chunks allocated through any Counted, in all
+     */
+    template <typename T>
+    struct Counted : std::allocator<T> {
+        template <typename U>
+        struct rebind {
+            typedef Counted<U> other;};
+
+        static long chunks;
+
+        Counted () {}
+
+        template <typename U>
+        Counted (const Counted<U>&) : std::allocator<T>() {}
+
+        T* allocate (std::size_t n) {
+            ++chunks;
+            return std::allocator<T>::allocate(n);}};
+
+    // ----
+    // push
+    // ----
+
+    void test_push_back_1 () {
+        const P a(4);
+        const P b = a.push_back(1).push_back(2);
+        CPPUNIT_ASSERT(a.empty());
+        CPPUNIT_ASSERT(b.size() == 2);
+        CPPUNIT_ASSERT(b.front() == 1);
+        CPPUNIT_ASSERT(b.back() == 2);}
+
+    void test_push_back_2 () {
+        P a(4);
+        for (int i = 0; i != 100; ++i)
+            a = a.push_back(i);
+        CPPUNIT_ASSERT(a.size() == 100);
+        for (int i = 0; i != 100; ++i)
+            CPPUNIT_ASSERT(a[i] == i);}
+
+    void test_push_front_1 () {
+        P a(4);
+        for (int i = 0; i != 100; ++i)
+            a = a.push_front(i);
+        CPPUNIT_ASSERT(a.size() == 100);
+        for (int i = 0; i != 100; ++i)
+            CPPUNIT_ASSERT(a[i] == 99 - i);}
+
+    void test_push_front_2 () {
+        const P a = P(4).push_back(1);
+        const P b = a.push_front(0);
+        CPPUNIT_ASSERT(b[0] == 0);
+        CPPUNIT_ASSERT(b[1] == 1);
+        CPPUNIT_ASSERT(a.size() == 1);}
+
+    // --------
+    // versions
+    // --------
+
+    void test_versions_1 () {
+        const P a = P(4).push_back(1).push_back(2);
+        const P b = a.push_back(3);
+        const P c = a.push_back(4);
+        CPPUNIT_ASSERT(b.back() == 3);
+        CPPUNIT_ASSERT(c.back() == 4);
+        CPPUNIT_ASSERT(a.size() == 2);}
+
+    void test_versions_2 () {
+        std::vector<P> v(1, P(8));
+        for (int i = 0; i != 200; ++i)
+            v.push_back((i % 2) ? v.back().push_front(i) : v.back().push_back(i));
+        std::deque<int> d;
+        for (int i = 0; i != 200; ++i) {
+            if (i % 2)
+                d.push_front(i);
+            else
+                d.push_back(i);
+            CPPUNIT_ASSERT(v[i + 1].size() == d.size());
+            CPPUNIT_ASSERT(v[i + 1].front() == d.front());
+            CPPUNIT_ASSERT(v[i + 1].back() == d.back());}
+        for (int i = 0; i != 200; ++i)
+            CPPUNIT_ASSERT(v.back()[i] == d[i]);}
+
+    // ---
+    // pop
+    // ---
+
+    void test_pop_front_1 () {
+        P a(4);
+        for (int i = 0; i != 50; ++i)
+            a = a.push_back(i);
+        const P b = a.pop_front().pop_front();
+        CPPUNIT_ASSERT(b.size() == 48);
+        CPPUNIT_ASSERT(b.front() == 2);
+        CPPUNIT_ASSERT(a.front() == 0);}
+
+    void test_pop_front_2 () {
+        P a(4);
+        for (int i = 0; i != 50; ++i)
+            a = a.push_back(i);
+        for (int i = 0; i != 50; ++i) {
+            CPPUNIT_ASSERT(a.front() == i);
+            a = a.pop_front();}
+        CPPUNIT_ASSERT(a.empty());}
+
+    void test_pop_back_1 () {
+        P a(4);
+        for (int i = 0; i != 50; ++i)
+            a = a.push_front(i);
+        for (int i = 0; i != 50; ++i) {
+            CPPUNIT_ASSERT(a.back() == i);
+            a = a.pop_back();}
+        CPPUNIT_ASSERT(a.empty());}
+
+    void test_pop_back_2 () {
+        const P a = P(4).push_back(1).push_back(2);
+        const P b = a.pop_back().push_back(3);
+        CPPUNIT_ASSERT(a.back() == 2);
+        CPPUNIT_ASSERT(b.back() == 3);}
+
+    void test_pop_back_3 () {
+        typedef PersistentDeque< int, Counted<int> > Q;
+        Q a(8);
+        for (int i = 0; i != 100; ++i)
+            a = a.push_back(i);
+        const long m = Counted<int>::chunks;
+        for (int i = 0; i != 1000; ++i) {
+            a = a.push_back(i);
+            CPPUNIT_ASSERT(a.back() == i);
+            a = a.pop_back();}
+        CPPUNIT_ASSERT(Counted<int>::chunks == m);
+        CPPUNIT_ASSERT(a.size() == 100);
+        CPPUNIT_ASSERT(a.back() == 99);
+        const Q b = a.pop_back();
+        const Q c = b.push_back(-1);
+        CPPUNIT_ASSERT(a.back() == 99);
+        CPPUNIT_ASSERT(c.back() == -1);}
+
+    void test_pop_front_3 () {
+        typedef PersistentDeque< int, Counted<int> > Q;
+        Q a(8);
+        for (int i = 0; i != 100; ++i)
+            a = a.push_front(i);
+        const long m = Counted<int>::chunks;
+        for (int i = 0; i != 1000; ++i) {
+            a = a.pop_front();
+            a = a.push_front(i);
+            CPPUNIT_ASSERT(a.front() == i);}
+        CPPUNIT_ASSERT(Counted<int>::chunks == m);
+        CPPUNIT_ASSERT(a.size() == 100);
+        CPPUNIT_ASSERT(a[1] == 98);}
+
+    // ------
+    // concat
+    // ------
+
+    void test_concat_1 () {
+        P a(4);
+        P b(4);
+        for (int i = 0; i != 30; ++i) {
+            a = a.push_back(i);
+            b = b.push_back(30 + i);}
+        const P c = a.concat(b);
+        CPPUNIT_ASSERT(c.size() == 60);
+        for (int i = 0; i != 60; ++i)
+            CPPUNIT_ASSERT(c[i] == i);
+        CPPUNIT_ASSERT(a.size() == 30);
+        CPPUNIT_ASSERT(b.front() == 30);}
+
+    void test_concat_2 () {
+        const P a = P(4).push_back(1);
+        CPPUNIT_ASSERT(a.concat(P(4)) == a);
+        CPPUNIT_ASSERT(P(4).concat(a) == a);}
+
+    // --------
+    // split_at
+    // --------
+
+    void test_split_at_1 () {
+        P a(4);
+        for (int i = 0; i != 100; ++i)
+            a = a.push_back(i);
+        for (int k = 0; k <= 100; k += 7) {
+            const std::pair<P, P> p = a.split_at(k);
+            CPPUNIT_ASSERT(p.first.size() == unsigned(k));
+            CPPUNIT_ASSERT(p.second.size() == unsigned(100 - k));
+            CPPUNIT_ASSERT(p.first.concat(p.second) == a);}}
+
+    void test_split_at_2 () {
+        P a(4);
+        for (int i = 0; i != 20; ++i)
+            a = a.push_back(i);
+        const std::pair<P, P> p = a.split_at(10);
+        const P b = p.first.push_back(-1);
+        const P c = p.second.pop_front().push_front(-2);
+        CPPUNIT_ASSERT(b.back() == -1);
+        CPPUNIT_ASSERT(c.front() == -2);
+        CPPUNIT_ASSERT(a[10] == 10);
+        CPPUNIT_ASSERT(a.size() == 20);}
+
+    void test_split_at_3 () {
+        try {
+            P(4).split_at(1);
+            CPPUNIT_ASSERT(false);}
+        catch (std::out_of_range& e) {
+            CPPUNIT_ASSERT(true);}}
+
+    // --
+    // at
+    // --
+
+    void test_at_1 () {
+        const P a = P(4).push_back(1);
+        try {
+            a.at(1);
+            CPPUNIT_ASSERT(false);}
+        catch (std::out_of_range& e) {
+            CPPUNIT_ASSERT(a.at(0) == 1);}}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestPersistentDeque);
+    CPPUNIT_TEST(test_push_back_1);
+    CPPUNIT_TEST(test_push_back_2);
+    CPPUNIT_TEST(test_push_front_1);
+    CPPUNIT_TEST(test_push_front_2);
+    CPPUNIT_TEST(test_versions_1);
+    CPPUNIT_TEST(test_versions_2);
+    CPPUNIT_TEST(test_pop_front_1);
+    CPPUNIT_TEST(test_pop_front_2);
+    CPPUNIT_TEST(test_pop_back_1);
+    CPPUNIT_TEST(test_pop_back_2);
+    CPPUNIT_TEST(test_pop_back_3);
+    CPPUNIT_TEST(test_pop_front_3);
+    CPPUNIT_TEST(test_concat_1);
+    CPPUNIT_TEST(test_concat_2);
+    CPPUNIT_TEST(test_split_at_1);
+    CPPUNIT_TEST(test_split_at_2);
+    CPPUNIT_TEST(test_split_at_3);
+    CPPUNIT_TEST(test_at_1);
+    CPPUNIT_TEST_SUITE_END();};
+
+template <typename T>
+long TestPersistentDeque::Counted<T>::chunks = 0;
+
+// ----
+// main
+// ----
+
+int main () {
+    using namespace std;
+    ios_base::sync_with_stdio(false); // turn off synchronization with C I/O
+    cout << "TestPersistentDeque.c++" << endl << endl;
+
+    CppUnit::TextTestRunner tr;
+    tr.addTest(TestPersistentDeque::suite());
+    tr.run();
+
+    cout << "Done." << endl;
+    return 0;}
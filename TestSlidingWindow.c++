@@ -0,0 +1,155 @@
+// ------------------------------------
+// projects/deque/TestSlidingWindow.c++
+// Copyright (C) 2012
+// Glenn P. Downing
+// ------------------------------------
+
+/*
+To test the program:
+% g++ -ansi -pedantic -lcppunit -ldl -Wall TestSlidingWindow.c++ -o TestSlidingWindow.c++.app
+% valgrind TestSlidingWindow.c++.app >& TestSlidingWindow.out
+*/
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max_element, min_element
+#include <cstdlib> // rand, srand
+#include <deque> // deque
+#include <numeric> // accumulate
+#include <string> // string
+
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE_END
+#include "cppunit/TestFixture.h" // TestFixture
+#include "cppunit/TextTestRunner.h" // TestRunner
+
+#include "SlidingWindow.h"
+
+// -----------------
+// TestSlidingWindow
+// -----------------
+
+struct TestSlidingWindow : CppUnit::TestFixture {
+    typedef SlidingWindow<int> W;
+
+    // ---------
+    // push_back
+    // ---------
+
+    void test_push_back_1 () {
+        W x;
+        x.push_back(3);
+        CPPUNIT_ASSERT(x.size() == 1);
+        CPPUNIT_ASSERT(x.min() == 3);
+        CPPUNIT_ASSERT(x.max() == 3);
+        CPPUNIT_ASSERT(x.aggregate() == 3);}
+
+    void test_push_back_2 () {
+        W x;
+        x.push_back(3);
+        x.push_back(1);
+        x.push_back(2);
+        CPPUNIT_ASSERT(x.min() == 1);
+        CPPUNIT_ASSERT(x.max() == 3);
+        CPPUNIT_ASSERT(x.aggregate() == 6);
+        CPPUNIT_ASSERT(x.front() == 3);
+        CPPUNIT_ASSERT(x.back() == 2);}
+
+    // ---------
+    // pop_front
+    // ---------
+
+    void test_pop_front_1 () {
+        W x;
+        x.push_back(3);
+        x.push_back(1);
+        x.push_back(2);
+        x.pop_front();
+        CPPUNIT_ASSERT(x.max() == 2);
+        CPPUNIT_ASSERT(x.aggregate() == 3);
+        x.pop_front();
+        CPPUNIT_ASSERT(x.min() == 2);
+        x.pop_front();
+        CPPUNIT_ASSERT(x.empty());}
+
+    void test_pop_front_2 () {
+        W x;
+        x.push_back(1);
+        x.push_back(1);
+        x.push_back(2);
+        x.pop_front();
+        CPPUNIT_ASSERT(x.min() == 1);
+        x.pop_front();
+        CPPUNIT_ASSERT(x.min() == 2);}
+
+    // ------
+    // random
+    // ------
+
+    void test_random_1 () {
+        std::srand(0);
+        W x;
+        std::deque<int> d;
+        for (int i = 0; i != 20000; ++i) {
+            if (d.empty() || (std::rand() % 3)) {
+                const int v = std::rand() % 1000 - 500;
+                x.push_back(v);
+                d.push_back(v);}
+            else {
+                x.pop_front();
+                d.pop_front();}
+            CPPUNIT_ASSERT(x.size() == d.size());
+            if (!d.empty()) {
+                CPPUNIT_ASSERT(x.min() == *std::min_element(d.begin(), d.end()));
+                CPPUNIT_ASSERT(x.max() == *std::max_element(d.begin(), d.end()));
+                CPPUNIT_ASSERT(x.aggregate() == std::accumulate(d.begin(), d.end(), 0));}}}
+
+    // ---------
+    // aggregate
+    // ---------
+
+    void test_aggregate_1 () {
+        SlidingWindow<std::string> x;
+        x.push_back("a");
+        x.push_back("b");
+        x.push_back("c");
+        CPPUNIT_ASSERT(x.aggregate() == "abc");
+        x.pop_front();
+        x.push_back("d");
+        CPPUNIT_ASSERT(x.aggregate() == "bcd");
+        x.pop_front();
+        x.pop_front();
+        x.push_back("e");
+        CPPUNIT_ASSERT(x.aggregate() == "de");
+        CPPUNIT_ASSERT(x.min() == "d");
+        CPPUNIT_ASSERT(x.max() == "e");}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestSlidingWindow);
+    CPPUNIT_TEST(test_push_back_1);
+    CPPUNIT_TEST(test_push_back_2);
+    CPPUNIT_TEST(test_pop_front_1);
+    CPPUNIT_TEST(test_pop_front_2);
+    CPPUNIT_TEST(test_random_1);
+    CPPUNIT_TEST(test_aggregate_1);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ----
+// main
+// ----
+
+int main () {
+    using namespace std;
+    ios_base::sync_with_stdio(false); // turn off synchronization with C I/O
+    cout << "TestSlidingWindow.c++" << endl << endl;
+
+    CppUnit::TextTestRunner tr;
+    tr.addTest(TestSlidingWindow::suite());
+    tr.run();
+
+    cout << "Done." << endl;
+    return 0;}
@@ -0,0 +1,232 @@
+// ----------------------------------
+// projects/deque/TestStaticDeque.c++
+// Copyright (C) 2012
+// Glenn P. Downing
+// ----------------------------------
+
+/*
+To test the program:
+% g++ -ansi -pedantic -lcppunit -ldl -Wall TestStaticDeque.c++ -o TestStaticDeque.c++.app
+% valgrind TestStaticDeque.c++.app >& TestStaticDeque.out
+*/
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // equal
+#include <cstdlib> // rand, srand
+#include <deque> // deque
+#include <stdexcept> // length_error, out_of_range
+#include <string> // string
+
+#include "cppunit/extensions/HelperMacros.h" // CPPUNIT_TEST, CPPUNIT_TEST_SUITE, CPPUNIT_TEST_SUITE_END
+#include "cppunit/TestFixture.h" // TestFixture
+#include "cppunit/TextTestRunner.h" // TestRunner
+
+#include "StaticDeque.h"
+
+// ---------------
+// TestStaticDeque
+// ---------------
+
+struct TestStaticDeque : CppUnit::TestFixture {
+    // --------------
+    // push_back, pop
+    // --------------
+
+    void test_push_1 () {
+        StaticDeque<int, 4> x;
+        CPPUNIT_ASSERT(x.empty());
+        x.push_back(2);
+        x.push_front(1);
+        x.push_back(3);
+        CPPUNIT_ASSERT(x.size() == 3);
+        CPPUNIT_ASSERT(x.front() == 1);
+        CPPUNIT_ASSERT(x.back() == 3);
+        CPPUNIT_ASSERT(x[1] == 2);
+        x.pop_front();
+        x.pop_back();
+        CPPUNIT_ASSERT(x.size() == 1);
+        CPPUNIT_ASSERT(x.front() == 2);}
+
+    void test_push_2 () {
+        StaticDeque<std::string, 5> x;
+        std::deque<std::string> y;
+        std::srand(0);
+        for (int i = 0; i != 10000; ++i) {
+            const int r = std::rand() % 4;
+            const std::string s(i % 5 + 1, char('a' + i % 26));
+            if ((r == 0) && !x.full()) {
+                x.push_back(s);
+                y.push_back(s);}
+            else if ((r == 1) && !x.full()) {
+                x.push_front(s);
+                y.push_front(s);}
+            else if ((r == 2) && !x.empty()) {
+                x.pop_back();
+                y.pop_back();}
+            else if (!x.empty()) {
+                x.pop_front();
+                y.pop_front();}
+            CPPUNIT_ASSERT(x.size() == y.size());
+            CPPUNIT_ASSERT(std::equal(x.begin(), x.end(), y.begin()));}}
+
+    // --------
+    // overflow
+    // --------
+
+    void test_overflow_1 () {
+        StaticDeque<int, 2> x;
+        x.push_back(1);
+        x.push_back(2);
+        try {
+            x.push_back(3);
+            CPPUNIT_ASSERT(false);}
+        catch (std::length_error&) {}
+        CPPUNIT_ASSERT(x.size() == 2);
+        CPPUNIT_ASSERT(x.back() == 2);}
+
+    void test_overflow_2 () {
+        StaticDeque<int, 2, reject_on_overflow> x;
+        CPPUNIT_ASSERT(x.push_back(1));
+        CPPUNIT_ASSERT(x.push_front(0));
+        CPPUNIT_ASSERT(!x.push_back(2));
+        CPPUNIT_ASSERT(!x.push_front(-1));
+        CPPUNIT_ASSERT(x.insert(x.begin() + 1, 5) == x.end());
+        CPPUNIT_ASSERT(x.front() == 0);
+        CPPUNIT_ASSERT(x.back() == 1);}
+
+    void test_overflow_3 () {
+        StaticDeque<int, 3, overwrite_on_overflow> x;
+        for (int i = 0; i != 10; ++i)
+            CPPUNIT_ASSERT(x.push_back(i));
+        CPPUNIT_ASSERT(x.size() == 3);
+        CPPUNIT_ASSERT(x[0] == 7);
+        CPPUNIT_ASSERT(x[2] == 9);
+        x.push_front(6);
+        CPPUNIT_ASSERT(x[0] == 6);
+        CPPUNIT_ASSERT(x[2] == 8);}
+
+    // ------
+    // insert
+    // ------
+
+    void test_insert_1 () {
+        StaticDeque<int, 8> x;
+        std::deque<int> y;
+        for (int i = 0; i != 8; ++i) {
+            const int k = (i * 5) % (x.size() + 1);
+            CPPUNIT_ASSERT(*x.insert(x.begin() + k, i) == i);
+            y.insert(y.begin() + k, i);
+            CPPUNIT_ASSERT(std::equal(x.begin(), x.end(), y.begin()));}
+        CPPUNIT_ASSERT(x.full());}
+
+    void test_insert_2 () {
+        StaticDeque<int, 4, overwrite_on_overflow> x;
+        for (int i = 0; i != 4; ++i)
+            x.push_back(i);
+        x.insert(x.begin() + 2, 9);
+        CPPUNIT_ASSERT(x.size() == 4);
+        CPPUNIT_ASSERT(x[0] == 1);
+        CPPUNIT_ASSERT(x[1] == 9);
+        CPPUNIT_ASSERT(x[2] == 2);
+        CPPUNIT_ASSERT(x[3] == 3);}
+
+    // -----
+    // erase
+    // -----
+
+    void test_erase_1 () {
+        StaticDeque<int, 8> x;
+        std::deque<int> y;
+        for (int i = 0; i != 8; ++i) {
+            x.push_back(i);
+            y.push_back(i);}
+        x.pop_front();
+        y.pop_front();
+        x.push_back(8);
+        y.push_back(8);
+        for (int i = 0; !y.empty(); ++i) {
+            const int k = (i * 5) % y.size();
+            x.erase(x.begin() + k);
+            y.erase(y.begin() + k);
+            CPPUNIT_ASSERT(x.size() == y.size());
+            CPPUNIT_ASSERT(std::equal(x.begin(), x.end(), y.begin()));}}
+
+    // ----
+    // copy
+    // ----
+
+    void test_copy_1 () {
+        StaticDeque<std::string, 3> x(2, "a");
+        StaticDeque<std::string, 3> y(x);
+        CPPUNIT_ASSERT(x == y);
+        y.push_back("b");
+        CPPUNIT_ASSERT(x < y);
+        x = y;
+        CPPUNIT_ASSERT(x == y);
+        y.pop_front();
+        y.pop_front();
+        x = y;
+        CPPUNIT_ASSERT(x.size() == 1);
+        CPPUNIT_ASSERT(x.front() == "b");}
+
+    void test_swap_1 () {
+        StaticDeque<int, 4> x(3, 1);
+        StaticDeque<int, 4> y(1, 2);
+        x.swap(y);
+        CPPUNIT_ASSERT(x.size() == 1);
+        CPPUNIT_ASSERT(x[0] == 2);
+        CPPUNIT_ASSERT(y.size() == 3);
+        CPPUNIT_ASSERT(y[2] == 1);}
+
+    // --
+    // at
+    // --
+
+    void test_at_1 () {
+        const StaticDeque<int, 4> x(2, 7);
+        CPPUNIT_ASSERT(x.at(1) == 7);
+        try {
+            x.at(2);
+            CPPUNIT_ASSERT(false);}
+        catch (std::out_of_range&) {}
+        try {
+            StaticDeque<int, 4> y(5);
+            CPPUNIT_ASSERT(false);}
+        catch (std::length_error&) {}}
+
+    // -----
+    // suite
+    // -----
+
+    CPPUNIT_TEST_SUITE(TestStaticDeque);
+    CPPUNIT_TEST(test_push_1);
+    CPPUNIT_TEST(test_push_2);
+    CPPUNIT_TEST(test_overflow_1);
+    CPPUNIT_TEST(test_overflow_2);
+    CPPUNIT_TEST(test_overflow_3);
+    CPPUNIT_TEST(test_insert_1);
+    CPPUNIT_TEST(test_insert_2);
+    CPPUNIT_TEST(test_erase_1);
+    CPPUNIT_TEST(test_copy_1);
+    CPPUNIT_TEST(test_swap_1);
+    CPPUNIT_TEST(test_at_1);
+    CPPUNIT_TEST_SUITE_END();};
+
+// ----
+// main
+// ----
+
+int main () {
+    using namespace std;
+    ios_base::sync_with_stdio(false); // turn off synchronization with C I/O
+    cout << "TestStaticDeque.c++" << endl << endl;
+
+    CppUnit::TextTestRunner tr;
+    tr.addTest(TestStaticDeque::suite());
+    tr.run();
+
+    cout << "Done." << endl;
+    return 0;}